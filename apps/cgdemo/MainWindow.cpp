@@ -28,10 +28,12 @@
 // Source file for cg demo main window.
 //
 // Author: Paulo Pagliosa
-// Last revision: 11/03/2022
+// Last revision: 19/10/2026
 
+#include "core/MemoryAccounting.h"
 #include "graphics/Application.h"
 #include "reader/SceneReader.h"
+#include "utils/Stopwatch.h"
 #include "MainWindow.h"
 
 
@@ -229,7 +231,38 @@ MainWindow::mainMenu()
         RayTracer::minMinWeight,
         1.0f);
 
+      ImGui::Combo("Termination",
+        &_termination,
+        "Threshold\0Russian Roulette\0Ray Budget\0");
+      if (_termination == 2)
+        ImGui::DragFloat("Reflection Rays per Pixel",
+          &_raysPerPixel,
+          0.1f,
+          0.0f,
+          20.0f);
       ImGui::SliderInt("Max Surpesampling Depth", &_maxDepth, 0, 4);
+      if (_maxDepth > 0)
+      {
+        ImGui::DragFloat("Contrast Threshold",
+          &_contrastThreshold,
+          0.01f,
+          0.0f,
+          1.0f);
+        ImGui::SliderInt("Pixel Sample Budget",
+          &_pixelSampleBudget,
+          RayTracer::minPixelSampleBudget,
+          256);
+        ImGui::DragFloat("Frame Sample Budget",
+          &_frameSampleBudget,
+          0.1f,
+          1.0f,
+          256.0f);
+      }
+      ImGui::Checkbox("Wavefront Pipeline", &_wavefront);
+      if (_wavefront)
+        ImGui::Checkbox("Sort Reflection Rays", &_raySorting);
+      ImGui::Checkbox("SIMD Shading", &_simdShading);
+      ImGui::SliderInt("Worker Processes", &_workerCount, 0, 16);
       ImGui::EndMenu();
       
     }
@@ -305,7 +338,46 @@ MainWindow::renderScene()
       _rayTracer->setCamera(*camera);
     _rayTracer->setMaxRecursionLevel(_maxRecursionLevel);
     _rayTracer->setMinWeight(_minWeight);
-    _rayTracer->renderImage(*_image, _maxDepth);
+    _rayTracer->setPipeline(_wavefront ?
+      RayTracer::Pipeline::Wavefront :
+      RayTracer::Pipeline::Recursive);
+    _rayTracer->setRaySorting(_raySorting);
+    _rayTracer->setSimdShading(_simdShading);
+    _rayTracer->setContrastThreshold(_contrastThreshold);
+    _rayTracer->setPixelSampleBudget(_pixelSampleBudget);
+    _rayTracer->setFrameSampleBudget(_frameSampleBudget);
+    switch (_termination)
+    {
+      case 1:
+        _rayTracer->setTerminationPolicy(new RussianRoulette);
+        break;
+      case 2:
+        _rayTracer->setTerminationPolicy(new RayBudgetTermination{
+          _raysPerPixel});
+        break;
+      default:
+        _rayTracer->setTerminationPolicy(nullptr);
+    }
+
+    RenderTelemetry telemetry;
+
+    if (_workerCount > 0)
+    {
+      TileRenderer renderer{*_rayTracer, _workerCount};
+
+      telemetry = renderer.renderImage(*_image, _maxDepth);
+    }
+    else
+      telemetry = _rayTracer->renderImage(*_image, _maxDepth);
+
+    Stopwatch timer;
+
+    timer.start();
+    _image->draw(0, 0);
+    telemetry.displayTime = timer.time();
+    printf("Telemetry: %s\n", telemetry.toJSON().c_str());
+    printf("Memory: %s\n", MemoryAccounting::toJSON().c_str());
+    return;
   }
   _image->draw(0, 0);
 }
@@ -28,7 +28,7 @@
 // Class definition for cg demo main window.
 //
 // Author: Paulo Pagliosa
-// Last revision: 22/07/2022
+// Last revision: 19/10/2026
 
 #ifndef __MainWindow_h
 #define __MainWindow_h
@@ -36,6 +36,7 @@
 #include "graphics/Assets.h"
 #include "graphics/GLImage.h"
 #include "RayTracer.h"
+#include "TileRenderer.h"
 #include "SweeperProxy.h"
 #include "MySceneWindow.h"
 
@@ -61,7 +62,16 @@ private:
   Reference<GLImage> _image;
   int _maxRecursionLevel{6};
   float _minWeight{RayTracer::minMinWeight};
+  int _termination{0};
+  float _raysPerPixel{2};
   int _maxDepth{ 2 };
+  float _contrastThreshold{0.4f};
+  int _pixelSampleBudget{64};
+  float _frameSampleBudget{16};
+  bool _wavefront{false};
+  bool _raySorting{false};
+  bool _simdShading{false};
+  int _workerCount{0};
 
   static MeshMap _defaultMeshes;
 
@@ -0,0 +1,571 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2026 Paulo Pagliosa.                              |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: PhongKernel.cpp
+// ========
+// Source file for vectorized Phong shading kernel.
+//
+// Author: Paulo Pagliosa
+// Last revision: 19/10/2026
+
+#include "PhongKernel.h"
+#include <cfloat>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+  (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define _SSE2_SHADING
+#include <emmintrin.h>
+#endif
+
+namespace cg
+{ // begin namespace cg
+
+namespace
+{ // begin namespace
+
+#ifdef _SSE2_SHADING
+
+// Four floats in a SSE register. A mask has all bits of a lane set
+// if the lane is true, or cleared otherwise.
+struct vfloat
+{
+  static constexpr uint32_t width = 4;
+
+  __m128 v;
+
+  vfloat() = default;
+
+  vfloat(__m128 v):
+    v{v}
+  {
+    // do nothing
+  }
+
+  vfloat(float s):
+    v{_mm_set1_ps(s)}
+  {
+    // do nothing
+  }
+
+  static vfloat load(const float* p)
+  {
+    return _mm_load_ps(p);
+  }
+
+  void store(float* p) const
+  {
+    _mm_store_ps(p, v);
+  }
+
+  static vfloat allTrue()
+  {
+    return _mm_castsi128_ps(_mm_set1_epi32(-1));
+  }
+
+}; // vfloat
+
+#define VOP(op, f) \
+inline vfloat operator op(vfloat a, vfloat b) { return f(a.v, b.v); }
+
+VOP(+, _mm_add_ps)
+VOP(-, _mm_sub_ps)
+VOP(*, _mm_mul_ps)
+VOP(/, _mm_div_ps)
+VOP(<, _mm_cmplt_ps)
+VOP(<=, _mm_cmple_ps)
+VOP(>, _mm_cmpgt_ps)
+VOP(>=, _mm_cmpge_ps)
+VOP(&, _mm_and_ps)
+VOP(|, _mm_or_ps)
+
+#undef VOP
+
+inline vfloat
+min(vfloat a, vfloat b)
+{
+  return _mm_min_ps(a.v, b.v);
+}
+
+inline vfloat
+max(vfloat a, vfloat b)
+{
+  return _mm_max_ps(a.v, b.v);
+}
+
+inline vfloat
+sqrt(vfloat a)
+{
+  return _mm_sqrt_ps(a.v);
+}
+
+// Returns mask ? a : b
+inline vfloat
+select(vfloat mask, vfloat a, vfloat b)
+{
+  return _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v));
+}
+
+inline uint32_t
+bits(vfloat mask)
+{
+  return (uint32_t)_mm_movemask_ps(mask.v);
+}
+
+// Splits x > 0 into a mantissa in [1,2) and an exponent
+inline vfloat
+frexp2(vfloat x, vfloat& e)
+{
+  auto i = _mm_castps_si128(x.v);
+
+  e = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(i, 23),
+    _mm_set1_epi32(127)));
+  i = _mm_or_si128(_mm_and_si128(i, _mm_set1_epi32(0x7fffff)),
+    _mm_set1_epi32(0x3f800000));
+  return _mm_castsi128_ps(i);
+}
+
+// Returns x * 2^n, for an integer n in [-126,127]
+inline vfloat
+scale2(vfloat x, vfloat n)
+{
+  auto e = _mm_slli_epi32(_mm_cvtps_epi32(n.v), 23);
+
+  return _mm_castsi128_ps(_mm_add_epi32(_mm_castps_si128(x.v), e));
+}
+
+inline vfloat
+round(vfloat x)
+{
+  return _mm_cvtepi32_ps(_mm_cvtps_epi32(x.v));
+}
+
+#else // !_SSE2_SHADING
+
+// Portable version of the SSE2 type above
+struct vfloat
+{
+  static constexpr uint32_t width = 4;
+
+  float v[width];
+
+  vfloat() = default;
+
+  vfloat(float s)
+  {
+    for (auto& x : v)
+      x = s;
+  }
+
+  static vfloat load(const float* p)
+  {
+    vfloat a;
+
+    memcpy(a.v, p, sizeof a.v);
+    return a;
+  }
+
+  void store(float* p) const
+  {
+    memcpy(p, v, sizeof v);
+  }
+
+  static vfloat allTrue()
+  {
+    return fromBits(~0u);
+  }
+
+  static vfloat fromBits(uint32_t b)
+  {
+    float s;
+
+    memcpy(&s, &b, sizeof s);
+    return s;
+  }
+
+  uint32_t toBits(uint32_t i) const
+  {
+    uint32_t b;
+
+    memcpy(&b, v + i, sizeof b);
+    return b;
+  }
+
+}; // vfloat
+
+#define VOP(op) \
+inline vfloat operator op(vfloat a, vfloat b) \
+{ \
+  for (uint32_t i = 0; i < vfloat::width; ++i) a.v[i] = a.v[i] op b.v[i]; \
+  return a; \
+}
+#define VCMP(op) \
+inline vfloat operator op(vfloat a, vfloat b) \
+{ \
+  for (uint32_t i = 0; i < vfloat::width; ++i) \
+    a.v[i] = vfloat::fromBits(a.v[i] op b.v[i] ? ~0u : 0).v[0]; \
+  return a; \
+}
+#define VBIT(op) \
+inline vfloat operator op(vfloat a, vfloat b) \
+{ \
+  for (uint32_t i = 0; i < vfloat::width; ++i) \
+    a.v[i] = vfloat::fromBits(a.toBits(i) op b.toBits(i)).v[0]; \
+  return a; \
+}
+
+VOP(+)
+VOP(-)
+VOP(*)
+VOP(/)
+VCMP(<)
+VCMP(<=)
+VCMP(>)
+VCMP(>=)
+VBIT(&)
+VBIT(|)
+
+#undef VBIT
+#undef VCMP
+#undef VOP
+
+inline vfloat
+min(vfloat a, vfloat b)
+{
+  for (uint32_t i = 0; i < vfloat::width; ++i)
+    a.v[i] = a.v[i] < b.v[i] ? a.v[i] : b.v[i];
+  return a;
+}
+
+inline vfloat
+max(vfloat a, vfloat b)
+{
+  for (uint32_t i = 0; i < vfloat::width; ++i)
+    a.v[i] = a.v[i] > b.v[i] ? a.v[i] : b.v[i];
+  return a;
+}
+
+inline vfloat
+sqrt(vfloat a)
+{
+  for (auto& x : a.v)
+    x = std::sqrt(x);
+  return a;
+}
+
+inline vfloat
+select(vfloat mask, vfloat a, vfloat b)
+{
+  for (uint32_t i = 0; i < vfloat::width; ++i)
+    if (!mask.toBits(i))
+      a.v[i] = b.v[i];
+  return a;
+}
+
+inline uint32_t
+bits(vfloat mask)
+{
+  uint32_t b = 0;
+
+  for (uint32_t i = 0; i < vfloat::width; ++i)
+    b |= (mask.toBits(i) >> 31) << i;
+  return b;
+}
+
+inline vfloat
+frexp2(vfloat x, vfloat& e)
+{
+  for (uint32_t i = 0; i < vfloat::width; ++i)
+  {
+    auto b = x.toBits(i);
+
+    e.v[i] = float(int(b >> 23) - 127);
+    x.v[i] = vfloat::fromBits((b & 0x7fffff) | 0x3f800000).v[0];
+  }
+  return x;
+}
+
+inline vfloat
+scale2(vfloat x, vfloat n)
+{
+  for (uint32_t i = 0; i < vfloat::width; ++i)
+    x.v[i] = vfloat::fromBits(x.toBits(i) + (int(n.v[i]) << 23)).v[0];
+  return x;
+}
+
+inline vfloat
+round(vfloat x)
+{
+  for (auto& s : x.v)
+    s = std::nearbyint(s);
+  return x;
+}
+
+#endif // _SSE2_SHADING
+
+// Returns log2(x), for x >= FLT_MIN. The mantissa is reduced to
+// [sqrt(2)/2,sqrt(2)) and ln(1+t) is evaluated with the minimax
+// polynomial of the Cephes library (relative error about 1e-7).
+inline vfloat
+fastLog2(vfloat x)
+{
+  vfloat e;
+  auto m = frexp2(x, e);
+  auto big = m > vfloat{1.41421356f};
+
+  m = select(big, m * vfloat{0.5f}, m);
+  e = select(big, e + vfloat{1}, e);
+
+  auto t = m - vfloat{1};
+  auto z = t * t;
+  auto p = vfloat{7.0376836292e-2f};
+
+  p = p * t + vfloat{-1.1514610310e-1f};
+  p = p * t + vfloat{1.1676998740e-1f};
+  p = p * t + vfloat{-1.2420140846e-1f};
+  p = p * t + vfloat{1.4249322787e-1f};
+  p = p * t + vfloat{-1.6668057665e-1f};
+  p = p * t + vfloat{2.0000714765e-1f};
+  p = p * t + vfloat{-2.4999993993e-1f};
+  p = p * t + vfloat{3.3333331174e-1f};
+  p = p * t * z - vfloat{0.5f} * z + t;
+  return p * vfloat{1.44269504f} + e;
+}
+
+// Returns 2^x. The fraction of x is in [-0.5,0.5] and 2^f is evaluated
+// with the minimax polynomial of the Cephes library (relative error
+// about 2e-7). Results less than 2^-126 are flushed to zero.
+inline vfloat
+fastExp2(vfloat x)
+{
+  auto zero = x < vfloat{-126};
+
+  // Keep 2^n within the range of the normal floats
+  x = min(max(x, vfloat{-126}), vfloat{127});
+
+  auto n = round(x);
+  auto f = x - n;
+  auto p = vfloat{1.535336188319500e-4f};
+
+  p = p * f + vfloat{1.339887440266574e-3f};
+  p = p * f + vfloat{9.618437357674640e-3f};
+  p = p * f + vfloat{5.550332471162809e-2f};
+  p = p * f + vfloat{2.402264791363012e-1f};
+  p = p * f + vfloat{6.931472028550421e-1f};
+  p = p * f + vfloat{1};
+  return select(zero, vfloat{0}, scale2(p, n));
+}
+
+inline vfloat
+fastPow(vfloat x, vfloat y)
+{
+  return fastExp2(y * fastLog2(max(x, vfloat{FLT_MIN})));
+}
+
+} // end namespace
+
+float
+fastPow(float x, float y)
+{
+  alignas(16) float r[vfloat::width];
+
+  fastPow(vfloat{x}, vfloat{y}).store(r);
+  return r[0];
+}
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// PhongLightData implementation
+// ==============
+void
+PhongLightData::set(const LightBVH& bvh)
+{
+  auto n = (uint32_t)bvh.lightCount();
+
+  for (auto v : {&kind, &attenuation})
+    v->resize(n);
+  for (auto v : {&x, &y, &z, &dx, &dy, &dz, &cosCutoff, &range, &r, &g, &b})
+    v->resize(n);
+  for (uint32_t i = 0; i < n; ++i)
+  {
+    const auto& light = *bvh.lights()[i];
+    const auto& c = light.color;
+    vec3f p;
+
+    r[i] = c.r, g[i] = c.g, b[i] = c.b;
+    range[i] = light.flags.isSet(Light::Infinite) ?
+      math::Limits<float>::inf() :
+      light.range();
+    cosCutoff[i] = -1;
+    dx[i] = dy[i] = dz[i] = 0;
+    if (light.type() == Light::Type::Directional)
+    {
+      kind[i] = Directional;
+      p = -light.direction().versor();
+    }
+    else
+    {
+      kind[i] = light.type() == Light::Type::Point ? Point : Spot;
+      p = light.position();
+      if (kind[i] == Spot)
+      {
+        const auto& d = light.direction();
+
+        dx[i] = d.x, dy[i] = d.y, dz[i] = d.z;
+        // Same test as Light::lightVector(), which compares the spot
+        // angle with twice toRadians(acos(D.L))
+        auto a = light.spotAngle() * float(90 / M_PI);
+
+        if (a < float(M_PI))
+          cosCutoff[i] = cos(a);
+      }
+    }
+    x[i] = p.x, y[i] = p.y, z[i] = p.z;
+    if (light.type() == Light::Type::Directional ||
+      light.falloff == Light::Falloff::Constant)
+      attenuation[i] = None;
+    else
+    {
+      auto quadratic = light.falloff == Light::Falloff::Quadratic;
+
+      if (light.flags.isSet(Light::Infinite))
+        attenuation[i] = quadratic ? InverseQuadratic : InverseLinear;
+      else
+        attenuation[i] = quadratic ? Quadratic : Linear;
+    }
+  }
+}
+
+void
+phongShade(const PhongBatch& batch,
+  const PhongLightData& lights,
+  uint32_t l,
+  PhongSample& s,
+  uint32_t laneMask)
+//[]---------------------------------------------------[]
+//|  Phong kernel                                       |
+//|  @param the batch of hits (input)                   |
+//|  @param the light data (input)                      |
+//|  @param index of the light                          |
+//|  @param the light sample (output)                   |
+//|  @param mask of the hits to be shaded               |
+//[]---------------------------------------------------[]
+{
+  constexpr auto w = vfloat::width;
+  const auto kind = lights.kind[l];
+  const auto attenuation = lights.attenuation[l];
+  const vfloat lr{lights.r[l]}, lg{lights.g[l]}, lb{lights.b[l]};
+  const vfloat zero{0};
+  uint32_t mask = 0;
+
+  laneMask &= (1u << batch.count) - 1;
+  for (uint32_t i = 0; i < batch.count; i += w)
+  {
+    if ((laneMask >> i & ((1u << w) - 1)) == 0)
+      continue;
+
+    vfloat Lx, Ly, Lz, d;
+    vfloat valid;
+
+    if (kind == PhongLightData::Directional)
+    {
+      Lx = lights.x[l], Ly = lights.y[l], Lz = lights.z[l];
+      d = math::Limits<float>::inf();
+      valid = vfloat::allTrue();
+    }
+    else
+    {
+      Lx = vfloat{lights.x[l]} - vfloat::load(batch.px + i);
+      Ly = vfloat{lights.y[l]} - vfloat::load(batch.py + i);
+      Lz = vfloat{lights.z[l]} - vfloat::load(batch.pz + i);
+      d = sqrt(Lx * Lx + Ly * Ly + Lz * Lz);
+      valid = (d > vfloat{math::Limits<float>::eps()}) &
+        (d <= vfloat{lights.range[l]});
+
+      auto invD = vfloat{1} / d;
+
+      Lx = Lx * invD, Ly = Ly * invD, Lz = Lz * invD;
+      if (kind == PhongLightData::Spot)
+      {
+        auto DL = vfloat{lights.dx[l]} * Lx + vfloat{lights.dy[l]} * Ly +
+          vfloat{lights.dz[l]} * Lz;
+
+        valid = valid & (DL < zero) & (DL >= vfloat{lights.cosCutoff[l]});
+      }
+    }
+
+    auto NL = vfloat::load(batch.nx + i) * Lx +
+      vfloat::load(batch.ny + i) * Ly +
+      vfloat::load(batch.nz + i) * Lz;
+
+    valid = valid & (NL > zero);
+
+    auto cr = lr, cg = lg, cb = lb;
+
+    if (attenuation != PhongLightData::None)
+    {
+      vfloat f;
+
+      if (attenuation >= PhongLightData::InverseLinear)
+      {
+        f = vfloat{1} / d;
+        if (attenuation == PhongLightData::InverseQuadratic)
+          f = f * f;
+      }
+      else
+      {
+        f = d / vfloat{lights.range[l]};
+        f = attenuation == PhongLightData::Quadratic ?
+          vfloat{1} + f * (f - vfloat{2}) :
+          vfloat{1} - f;
+      }
+      cr = cr * f, cg = cg * f, cb = cb * f;
+    }
+    (cr * vfloat::load(batch.dr + i) * NL).store(s.dr + i);
+    (cg * vfloat::load(batch.dg + i) * NL).store(s.dg + i);
+    (cb * vfloat::load(batch.db + i) * NL).store(s.db + i);
+
+    auto RL = vfloat::load(batch.rx + i) * Lx +
+      vfloat::load(batch.ry + i) * Ly +
+      vfloat::load(batch.rz + i) * Lz;
+    auto shine = vfloat::load(batch.shine + i);
+    auto p = select((shine > zero) & (RL > zero),
+      fastPow(RL, shine),
+      zero);
+
+    (cr * vfloat::load(batch.sr + i) * p).store(s.sr + i);
+    (cg * vfloat::load(batch.sg + i) * p).store(s.sg + i);
+    (cb * vfloat::load(batch.sb + i) * p).store(s.sb + i);
+    Lx.store(s.lx + i);
+    Ly.store(s.ly + i);
+    Lz.store(s.lz + i);
+    d.store(s.distance + i);
+    mask |= bits(valid) << i;
+  }
+  s.mask = mask & laneMask;
+}
+
+} // end namespace cg
@@ -0,0 +1,228 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2026 Paulo Pagliosa.                              |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: PhongKernel.h
+// ========
+// Class definition for vectorized Phong shading kernel.
+//
+// Author: Paulo Pagliosa
+// Last revision: 19/10/2026
+
+#ifndef __PhongKernel_h
+#define __PhongKernel_h
+
+#include "graphics/LightBVH.h"
+#include "graphics/Material.h"
+#include <cassert>
+
+namespace cg
+{ // begin namespace cg
+
+/**
+ *  Returns an approximation of pow(x, y), for x >= 0 and y > 0. The
+ *  relative error grows with |y log2(x)|, which is rounded to a float:
+ *  it is less than 2e-6 for results greater than 1e-3, and less than
+ *  2e-5 for results greater than 1e-30. Smaller results may be flushed
+ *  to zero.
+ */
+float fastPow(float x, float y);
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// PhongLightData: per-light data of the Phong kernel
+// ==============
+//
+// Structure of arrays with the light parameters read by the Phong
+// kernel, precomputed from the lights of a light BVH and indexed as
+// LightBVH::lights().
+//
+class PhongLightData
+{
+public:
+  enum Kind: uint8_t
+  {
+    Directional,
+    Point,
+    Spot
+  };
+
+  enum Attenuation: uint8_t
+  {
+    None,
+    Linear,
+    Quadratic,
+    InverseLinear,
+    InverseQuadratic
+  };
+
+  std::vector<uint8_t> kind;
+  std::vector<uint8_t> attenuation;
+  // Position of a point light or spotlight, or the light vector of
+  // a directional light
+  std::vector<float> x;
+  std::vector<float> y;
+  std::vector<float> z;
+  // Direction of a spotlight
+  std::vector<float> dx;
+  std::vector<float> dy;
+  std::vector<float> dz;
+  // Minimum cosine between the direction of a spotlight and -L
+  std::vector<float> cosCutoff;
+  // Range of a light, inf if infinite
+  std::vector<float> range;
+  // Color of a light
+  std::vector<float> r;
+  std::vector<float> g;
+  std::vector<float> b;
+
+  auto size() const
+  {
+    return (uint32_t)kind.size();
+  }
+
+  void set(const LightBVH&);
+
+}; // PhongLightData
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// PhongBatch: batch of hits to be shaded
+// ==========
+//
+// The lanes are zeroed on construction only. After clear(), the lanes
+// past count keep the data of earlier hits, which are finite values,
+// so the kernel never computes with denormals or NaNs. The results of
+// those lanes are masked out.
+//
+struct PhongBatch
+{
+  static constexpr uint32_t size = 8;
+
+  alignas(16) float px[size]{}; // hit point
+  alignas(16) float py[size]{};
+  alignas(16) float pz[size]{};
+  alignas(16) float nx[size]{}; // normal
+  alignas(16) float ny[size]{};
+  alignas(16) float nz[size]{};
+  alignas(16) float rx[size]{}; // reflection vector
+  alignas(16) float ry[size]{};
+  alignas(16) float rz[size]{};
+  alignas(16) float dr[size]{}; // material diffuse color
+  alignas(16) float dg[size]{};
+  alignas(16) float db[size]{};
+  alignas(16) float sr[size]{}; // material spot color
+  alignas(16) float sg[size]{};
+  alignas(16) float sb[size]{};
+  alignas(16) float shine[size]{};
+  uint32_t count{};
+
+  bool full() const
+  {
+    return count == size;
+  }
+
+  void clear()
+  {
+    count = 0;
+  }
+
+  /// Adds a hit to this batch and returns its lane.
+  uint32_t add(const vec3f& P,
+    const vec3f& N,
+    const vec3f& R,
+    const Material& m)
+  {
+    assert(count < size);
+
+    auto i = count++;
+
+    px[i] = P.x, py[i] = P.y, pz[i] = P.z;
+    nx[i] = N.x, ny[i] = N.y, nz[i] = N.z;
+    rx[i] = R.x, ry[i] = R.y, rz[i] = R.z;
+    dr[i] = m.diffuse.r, dg[i] = m.diffuse.g, db[i] = m.diffuse.b;
+    sr[i] = m.spot.r, sg[i] = m.spot.g, sb[i] = m.spot.b;
+    shine[i] = m.shine;
+    return i;
+  }
+
+}; // PhongBatch
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// PhongSample: direct lighting of a light at a batch of hits
+// ===========
+struct PhongSample
+{
+  static constexpr auto size = PhongBatch::size;
+
+  alignas(16) float lx[size]; // light vector
+  alignas(16) float ly[size];
+  alignas(16) float lz[size];
+  alignas(16) float distance[size];
+  alignas(16) float dr[size]; // diffuse term
+  alignas(16) float dg[size];
+  alignas(16) float db[size];
+  alignas(16) float sr[size]; // spot term
+  alignas(16) float sg[size];
+  alignas(16) float sb[size];
+  // Bit i is set if the light incides at the front of the hit i
+  uint32_t mask;
+
+  vec3f L(uint32_t i) const
+  {
+    return {lx[i], ly[i], lz[i]};
+  }
+
+  Color diffuse(uint32_t i) const
+  {
+    return Color{dr[i], dg[i], db[i]};
+  }
+
+  Color spot(uint32_t i) const
+  {
+    return Color{sr[i], sg[i], sb[i]};
+  }
+
+}; // PhongSample
+
+/**
+ *  Evaluates the Phong model for the light l at the hits of a batch
+ *  whose bits in laneMask are set. The terms are computed as in the
+ *  scalar shading code of the ray tracer, but with SIMD instructions
+ *  (SSE2, where available) and fastPow(); the visibility of the
+ *  light is not checked.
+ */
+void phongShade(const PhongBatch&,
+  const PhongLightData&,
+  uint32_t l,
+  PhongSample&,
+  uint32_t laneMask = ~0u);
+
+} // end namespace cg
+
+#endif // __PhongKernel_h
@@ -0,0 +1,313 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2026 Paulo Pagliosa.                              |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: RayQueue.h
+// ========
+// Class definition for ray queue.
+//
+// Author: Paulo Pagliosa
+// Last revision: 19/10/2026
+
+#ifndef __RayQueue_h
+#define __RayQueue_h
+
+#include "geometry/Bounds3.h"
+#include "graphics/Color.h"
+#include <algorithm>
+#include <cinttypes>
+#include <vector>
+
+namespace cg
+{ // begin namespace cg
+
+namespace rq
+{ // begin namespace rq
+
+// Spreads the 10 low bits of x so that there are two zeros between
+// consecutive bits
+inline uint32_t
+expandBits(uint32_t x)
+{
+  x &= 0x3ff;
+  x = (x | x << 16) & 0x30000ff;
+  x = (x | x << 8) & 0x300f00f;
+  x = (x | x << 4) & 0x30c30c3;
+  x = (x | x << 2) & 0x9249249;
+  return x;
+}
+
+// Returns the 30-bit Morton code of p, in [0,1]^3
+inline uint32_t
+mortonCode(const vec3f& p)
+{
+  auto q = [](float t)
+  {
+    return (uint32_t)math::min(math::max(t * 1024.0f, 0.0f), 1023.0f);
+  };
+
+  return expandBits(q(p.x)) << 2 | expandBits(q(p.y)) << 1 |
+    expandBits(q(p.z));
+}
+
+template <typename T>
+inline void
+permute(std::vector<T>& v,
+  const std::vector<uint32_t>& order,
+  std::vector<T>& temp)
+{
+  auto n = (uint32_t)order.size();
+
+  temp.resize(n);
+  for (uint32_t i = 0; i < n; ++i)
+    temp[i] = v[order[i]];
+  v.swap(temp);
+}
+
+} // end namespace rq
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// RayQueue: ray queue class
+// ========
+//
+// Structure of arrays holding a batch of rays to be intersected in
+// bulk. Each ray carries the index of the path (pixel) it belongs to
+// and its weight.
+//
+class RayQueue
+{
+public:
+  std::vector<float> ox;
+  std::vector<float> oy;
+  std::vector<float> oz;
+  std::vector<float> dx;
+  std::vector<float> dy;
+  std::vector<float> dz;
+  std::vector<float> tMin;
+  std::vector<float> tMax;
+  std::vector<uint32_t> path;
+  std::vector<float> weight;
+
+  auto size() const
+  {
+    return (uint32_t)path.size();
+  }
+
+  bool empty() const
+  {
+    return path.empty();
+  }
+
+  void reserve(uint32_t n)
+  {
+    ox.reserve(n);
+    oy.reserve(n);
+    oz.reserve(n);
+    dx.reserve(n);
+    dy.reserve(n);
+    dz.reserve(n);
+    tMin.reserve(n);
+    tMax.reserve(n);
+    path.reserve(n);
+    weight.reserve(n);
+  }
+
+  void clear()
+  {
+    ox.clear();
+    oy.clear();
+    oz.clear();
+    dx.clear();
+    dy.clear();
+    dz.clear();
+    tMin.clear();
+    tMax.clear();
+    path.clear();
+    weight.clear();
+  }
+
+  void push(const Ray3f& ray, uint32_t pathId, float w = 1)
+  {
+    ox.push_back(ray.origin.x);
+    oy.push_back(ray.origin.y);
+    oz.push_back(ray.origin.z);
+    dx.push_back(ray.direction.x);
+    dy.push_back(ray.direction.y);
+    dz.push_back(ray.direction.z);
+    tMin.push_back(ray.tMin);
+    tMax.push_back(ray.tMax);
+    path.push_back(pathId);
+    weight.push_back(w);
+  }
+
+  /// Returns the i-th ray of this queue.
+  Ray3f ray(uint32_t i) const
+  {
+    Ray3f r;
+
+    // The direction is already normalized
+    r.origin.set(ox[i], oy[i], oz[i]);
+    r.direction.set(dx[i], dy[i], dz[i]);
+    r.tMin = tMin[i];
+    r.tMax = tMax[i];
+    return r;
+  }
+
+  /**
+   *  Reorders the rays of this queue by direction octant and, within
+   *  an octant, by the Morton code of their origins in the bounds.
+   *  Rays with similar origins and directions are then intersected
+   *  one after the other, visiting the same nodes of the scene BVH.
+   */
+  void sort(const Bounds3f& bounds)
+  {
+    std::vector<uint32_t> order;
+
+    sortOrder(bounds, order);
+    permute(order);
+  }
+
+  /// Computes the coherent order of the rays of this queue.
+  void sortOrder(const Bounds3f& bounds, std::vector<uint32_t>& order) const
+  {
+    auto n = size();
+    auto p = bounds.min();
+    auto s = bounds.size();
+    std::vector<uint64_t> keys(n);
+
+    for (int i = 0; i < 3; ++i)
+      s[i] = s[i] > 0 ? math::inverse(s[i]) : 0;
+    for (uint32_t i = 0; i < n; ++i)
+    {
+      auto octant = uint64_t(dx[i] < 0) << 2 | uint64_t(dy[i] < 0) << 1 |
+        uint64_t(dz[i] < 0);
+      vec3f o{(ox[i] - p.x) * s.x, (oy[i] - p.y) * s.y, (oz[i] - p.z) * s.z};
+
+      // Octant (3 bits), Morton code (30 bits) and ray index (31 bits)
+      keys[i] = (octant << 30 | rq::mortonCode(o)) << 31 | i;
+    }
+    std::sort(keys.begin(), keys.end());
+    order.resize(n);
+    for (uint32_t i = 0; i < n; ++i)
+      order[i] = uint32_t(keys[i] & 0x7fffffff);
+  }
+
+  /// Moves the order[i]-th ray of this queue to the position i.
+  void permute(const std::vector<uint32_t>& order)
+  {
+    std::vector<float> tf;
+
+    rq::permute(ox, order, tf);
+    rq::permute(oy, order, tf);
+    rq::permute(oz, order, tf);
+    rq::permute(dx, order, tf);
+    rq::permute(dy, order, tf);
+    rq::permute(dz, order, tf);
+    rq::permute(tMin, order, tf);
+    rq::permute(tMax, order, tf);
+    rq::permute(weight, order, tf);
+
+    std::vector<uint32_t> tu;
+
+    rq::permute(path, order, tu);
+  }
+
+  void swap(RayQueue& other)
+  {
+    ox.swap(other.ox);
+    oy.swap(other.oy);
+    oz.swap(other.oz);
+    dx.swap(other.dx);
+    dy.swap(other.dy);
+    dz.swap(other.dz);
+    tMin.swap(other.tMin);
+    tMax.swap(other.tMax);
+    path.swap(other.path);
+    weight.swap(other.weight);
+  }
+
+}; // RayQueue
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// ShadowRayQueue: shadow ray queue class
+// ==============
+//
+// Queue of shadow rays. The path index of a shadow ray is the index
+// of the shaded hit; the direct lighting terms are added to the hit
+// color if the ray is not blocked. Note that sorting the queue changes
+// the order in which the terms of a hit are added.
+//
+class ShadowRayQueue: public RayQueue
+{
+public:
+  std::vector<Color> diffuse;
+  std::vector<Color> spot;
+
+  void reserve(uint32_t n)
+  {
+    RayQueue::reserve(n);
+    diffuse.reserve(n);
+    spot.reserve(n);
+  }
+
+  void clear()
+  {
+    RayQueue::clear();
+    diffuse.clear();
+    spot.clear();
+  }
+
+  void push(const Ray3f& ray, uint32_t hitId, const Color& d, const Color& s)
+  {
+    RayQueue::push(ray, hitId);
+    diffuse.push_back(d);
+    spot.push_back(s);
+  }
+
+  void sort(const Bounds3f& bounds)
+  {
+    std::vector<uint32_t> order;
+
+    sortOrder(bounds, order);
+    permute(order);
+  }
+
+  void permute(const std::vector<uint32_t>& order)
+  {
+    std::vector<Color> temp;
+
+    RayQueue::permute(order);
+    rq::permute(diffuse, order, temp);
+    rq::permute(spot, order, temp);
+  }
+
+}; // ShadowRayQueue
+
+} // end namespace cg
+
+#endif // __RayQueue_h
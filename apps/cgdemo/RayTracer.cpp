@@ -28,11 +28,12 @@
 // Source file for simple ray tracer.
 //
 // Author: Paulo Pagliosa
-// Last revision: 27/10/2022
+// Last revision: 19/10/2026
 
 #include "graphics/Camera.h"
 #include "utils/Stopwatch.h"
 #include "RayTracer.h"
+#include <algorithm>
 
 using namespace std;
 
@@ -58,7 +59,8 @@ printElapsedTime(const char* s, Stopwatch::ms_time time)
 RayTracer::RayTracer(SceneBase& scene, Camera& camera):
   Renderer{scene, camera},
   _maxRecursionLevel{6},
-  _minWeight{minMinWeight}
+  _minWeight{minMinWeight},
+  _termination{new ThresholdTermination}
 {
   // do nothing
 }
@@ -86,6 +88,17 @@ RayTracer::update()
       }
     }
   _bvh = new PrimitiveBVH{std::move(primitives)};
+  // Delete current light BVH before creating a new one
+  _lights = nullptr;
+
+  LightBVH::LightArray lights;
+
+  lights.reserve(_scene->lightCount());
+  for (auto& light : _scene->lights())
+    if (light->isTurnedOn())
+      lights.push_back(light);
+  _lights = new LightBVH{std::move(lights)};
+  _lightData.set(*_lights);
 }
 
 void
@@ -94,13 +107,56 @@ RayTracer::render()
   throw std::runtime_error("RayTracer::render() invoked");
 }
 
-void
+RenderTelemetry
 RayTracer::renderImage(Image& image, float maxDepth)
 {
+  return renderRegion(image, 0, 0, image.width(), image.height(), maxDepth);
+}
+
+RenderTelemetry
+RayTracer::renderRegion(Image& image,
+  int x,
+  int y,
+  int w,
+  int h,
+  float maxDepth)
+{
+  // Clip the region against the image
+  Viewport region;
+
+  region.x = math::max(x, 0);
+  region.y = math::max(y, 0);
+  region.w = math::min(x + w, image.width()) - region.x;
+  region.h = math::min(y + h, image.height()) - region.y;
+  if (region.w <= 0 || region.h <= 0)
+    return {};
+
   Stopwatch timer;
 
-  update();
   timer.start();
+  update();
+
+  auto updateTime = timer.lap();
+
+  setImage(image);
+  scan(image, region, maxDepth);
+  _telemetry.updateTime = updateTime;
+  _telemetry.scanTime = timer.lap();
+
+  auto t = telemetry();
+
+  printf("\nNumber of rays: %llu", (unsigned long long)t.rays());
+  printf("\nNumber of hits: %llu",
+    (unsigned long long)(t.hits + t.shadowHits));
+  if (maxDepth > 0)
+    printf("\nNumber of samples: %llu", (unsigned long long)t.samples);
+  printElapsedTime("\nDONE! ", t.scanTime);
+  return t;
+}
+
+void
+RayTracer::setImage(const Image& image)
+{
   {
     const auto& m = _camera->cameraToWorldMatrix();
 
@@ -111,18 +167,18 @@ RayTracer::renderImage(Image& image, float maxDepth)
   }
 
   // init auxiliary mapping variables
-  auto w = image.width(), h = image.height();
+  auto iw = image.width(), ih = image.height();
 
-  setImageSize(w, h);
-  _Iw = math::inverse(float(w));
-  _Ih = math::inverse(float(h));
+  setImageSize(iw, ih);
+  _Iw = math::inverse(float(iw));
+  _Ih = math::inverse(float(ih));
   {
     auto wh = _camera->windowHeight();
 
-    if (w >= h)
-      _Vw = (_Vh = wh) * w * _Ih;
+    if (iw >= ih)
+      _Vw = (_Vh = wh) * iw * _Ih;
     else
-      _Vh = (_Vw = wh) * h * _Iw;
+      _Vh = (_Vw = wh) * ih * _Iw;
   }
 
   // init pixel ray
@@ -138,14 +194,20 @@ RayTracer::renderImage(Image& image, float maxDepth)
   _pixelRay.tMin = F;
   _pixelRay.tMax = B;
   _pixelRay.set(_camera->position(), -_vrc.n);
-  _numberOfRays = _numberOfHits = 0;
-  scan(image, maxDepth);
+  _telemetry = {};
+  _telemetry.workers = 1;
+  _telemetry.termination = _termination->name();
+  _bvhSnapshot = bvhStats();
+  _termination->start(uint64_t(iw) * ih);
+}
 
-  auto et = timer.time();
+RenderTelemetry
+RayTracer::telemetry() const
+{
+  auto t = _telemetry;
 
-  printf("\nNumber of rays: %llu", _numberOfRays);
-  printf("\nNumber of hits: %llu", _numberOfHits);
-  printElapsedTime("\nDONE! ", et);
+  t.setBVHStats(bvhStats(), _bvhSnapshot);
+  return t;
 }
 
 void
@@ -155,91 +217,199 @@ RayTracer::setPixelRay(float x, float y)
 //|  @param x coordinate of the pixel                   |
 //|  @param y cordinates of the pixel                   |
 //[]---------------------------------------------------[]
+{
+  setPixelRay(_pixelRay, x, y);
+}
+
+void
+RayTracer::setPixelRay(Ray3f& ray, float x, float y) const
+//[]---------------------------------------------------[]
+//|  Set pixel ray                                      |
+//|  @param the pixel ray (input/output)                |
+//|  @param x coordinate of the pixel                   |
+//|  @param y cordinates of the pixel                   |
+//[]---------------------------------------------------[]
 {
   auto p = imageToWindow(x, y);
 
   switch (_camera->projectionType())
   {
     case Camera::Perspective:
-      _pixelRay.direction = (p - _camera->nearPlane() * _vrc.n).versor();
+      ray.direction = (p - _camera->nearPlane() * _vrc.n).versor();
       break;
 
     case Camera::Parallel:
-      _pixelRay.origin = _camera->position() + p;
+      ray.origin = _camera->position() + p;
       break;
   }
 }
 
 void
-RayTracer::scan(Image& image, float maxDepth)
+RayTracer::scan(Image& image, const Viewport& region, float maxDepth)
 {
-  ImageBuffer scanLine{_viewport.w, 1};
+  ImageBuffer scanLine{region.w, 1};
   // shoot values are cached in the shoot method.
   // every time you scan the scene, clear the rayMap
   _rayMap.clear();
+  _rayMapArena.reset();
 
-  if (maxDepth == 0) {
-      for (auto j = 0; j < _viewport.h; j++)
-      {
-          auto y = (float)j + 0.5f;
-
-          printf("Scanning line %d of %d\r", j + 1, _viewport.h);
-          for (auto i = 0; i < _viewport.w; i++)
-              scanLine[i] = shoot((float)i + 0.5f, y); 
-          image.setData(0, j, scanLine);       }
+  if (maxDepth == 0 && _pipeline == Pipeline::Wavefront)
+  {
+    scanWavefront(image, region);
+    return;
   }
-  else
+
+  // Samples available for the pixels not yet scanned
+  auto pixelsLeft = int64_t(region.w) * region.h;
+  auto samplesLeft = int64_t(_frameSampleBudget * pixelsLeft);
+
+  for (auto j = 0; j < region.h; j++)
   {
+    auto py = region.y + j;
 
-      for (auto j = 0; j < _viewport.h; j++)
+    printf("Scanning line %d of %d\r", j + 1, region.h);
+    for (auto i = 0; i < region.w; i++)
+    {
+      auto px = region.x + i;
+
+      _termination->beginPixels(1);
+      if (maxDepth == 0)
+        scanLine[i] = shoot((float)px + 0.5f, (float)py + 0.5f);
+      else
       {
-          auto y = (float)j + 0.5f;
+        auto budget = math::max(samplesLeft, int64_t(0)) / pixelsLeft--;
+        auto n = _telemetry.samples;
 
-          printf("Scanning line %d of %d\r", j + 1, _viewport.h);
-          for (auto i = 0; i < _viewport.w; i++)
-              scanLine[i] = supersampling((float)i, (float)(i + 1), (float)j, (float)(j+1), 0, maxDepth);  // <---- supersampling
-          image.setData(0, j, scanLine);
+        budget = math::min(budget, int64_t(_pixelSampleBudget));
+        scanLine[i] = supersample(px, py, int(maxDepth), int(budget));
+        samplesLeft -= int64_t(_telemetry.samples - n);
       }
+    }
+    image.setData(region.x, py, scanLine);
   }
+}
+
+namespace
+{ // begin namespace
 
+// Returns true if the contrast of the samples is perceptible (see
+// RayTracer::contrastThreshold())
+inline bool
+highContrast(const Color c[4], float threshold)
+{
+  static const float weight[]{1.0f, 0.75f, 1.5f};
+
+  for (auto k = 0; k < 3; ++k)
+  {
+    auto cMin = c[0][k], cMax = c[0][k];
+
+    for (auto i = 1; i < 4; ++i)
+    {
+      cMin = math::min(cMin, c[i][k]);
+      cMax = math::max(cMax, c[i][k]);
+    }
+    if (cMax - cMin > threshold * weight[k] * (cMax + cMin))
+      return true;
+  }
+  return false;
 }
+
+// Returns the sum of the RGB variances of the samples
+inline float
+variance(const Color c[4], const Color& mean)
+{
+  auto v = 0.0f;
+
+  for (auto i = 0; i < 4; ++i)
+    for (auto k = 0; k < 3; ++k)
+      v += math::sqr(c[i][k] - mean[k]);
+  return v * 0.25f;
+}
+
+} // end namespace
+
 Color
-RayTracer::supersampling(float minX, float maxX, float minY, float maxY, int depth, int maxDepth) 
+RayTracer::supersample(int x, int y, int maxDepth, int budget)
+//[]---------------------------------------------------[]
+//|  Adaptive supersampling of a pixel                  |
+//|  @param x coordinate of the pixel                   |
+//|  @param y coordinate of the pixel                   |
+//|  @param maximum subdivision depth                   |
+//|  @param maximum number of samples to trace          |
+//|  @return RGB color of the pixel                     |
+//[]---------------------------------------------------[]
 {
-    //  COR1*--------------*COR3             
-    //      |              |
-    //      |              |
-    //      |              |
-    //      |              |
-    //  COR2*--------------*COR4               
-    // 
-    //
-
-    auto color1 = shoot(minX, minY); 
-    auto color2 = shoot(minX, maxY);
-    auto color3 = shoot(maxX, minY);
-    auto color4 = shoot(maxX, maxY);
-
-    auto meanColor = (color1 * 0.25) + (color2 * 0.25) + (color3 * 0.25) + (color4 * 0.25);
-
-    if (depth == maxDepth) return meanColor;
-    
-    auto medX = minX + (maxX - minX) / 2;
-    auto medY = minY + (maxY - minY) / 2;
-
-    Color* color[4]; color[0] = &color1; color[1] = &color2;  color[2] = &color3; color[3] = &color4;
-    for (long i = 0; i < 4; i++) {
-        if (meanColor == *color[i]) continue;
-        
-        auto newMinX = i < 2 ? minX : medX;
-        auto newMinY = i % 2 == 0 ? minY : medY;
-        auto newMaxX = i < 2 ? medX : maxX;
-        auto newMaxY = i % 2 == 0 ? medY : maxY;
-        *color[i] = supersampling(newMinX, newMinX, newMinY, newMaxY, depth + 1,  maxDepth);
-    }   
-
-    meanColor = (color1 * 0.25) + (color2 * 0.25) + (color3 * 0.25) + (color4 * 0.25);
-    return meanColor;
+  // Square of the pixel whose color is estimated by the mean of
+  // the samples at its corners
+  struct Quad
+  {
+    float x;
+    float y;
+    float size;
+    int depth;
+    Color mean;
+    float priority;
+
+    bool operator <(const Quad& other) const
+    {
+      return priority < other.priority;
+    }
+
+  };
+
+  auto first = _telemetry.samples;
+  auto makeQuad = [&](float x, float y, float size, int depth)
+  {
+    Color c[4]
+    {
+      shoot(x, y),
+      shoot(x + size, y),
+      shoot(x, y + size),
+      shoot(x + size, y + size)
+    };
+    Quad q{x, y, size, depth};
+
+    q.mean = (c[0] + c[1] + c[2] + c[3]) * 0.25f;
+    // The quads with the largest variance estimates are refined first.
+    // A quad with no perceptible contrast is never refined.
+    q.priority = depth < maxDepth && highContrast(c, _contrastThreshold) ?
+      size * size * variance(c, q.mean) :
+      -1;
+    return q;
+  };
+
+  // The quad heap is a temporary of the arena of this thread
+  ArenaScope scope;
+  std::vector<Quad, ArenaAllocator<Quad>> quads;
+  auto color = Color::black;
+
+  quads.push_back(makeQuad(float(x), float(y), 1, 0));
+  while (!quads.empty())
+  {
+    std::pop_heap(quads.begin(), quads.end());
+
+    auto q = quads.back();
+
+    quads.pop_back();
+    // Refining a quad traces at most five new samples
+    if (q.priority < 0 || int(_telemetry.samples - first) + 5 > budget)
+    {
+      color += q.mean * (q.size * q.size);
+      continue;
+    }
+
+    auto s = q.size * 0.5f;
+
+    for (auto i = 0; i < 4; ++i)
+    {
+      quads.push_back(makeQuad(q.x + (i & 1) * s,
+        q.y + (i >> 1) * s,
+        s,
+        q.depth + 1));
+      std::push_heap(quads.begin(), quads.end());
+    }
+  }
+  return color;
 }
 
 Color
@@ -261,6 +431,9 @@ RayTracer::shoot(float x, float y)
       return search->second;
 
   setPixelRay(x, y);
+  ++_telemetry.samples;
+  _sampleX = x;
+  _sampleY = y;
 
   // trace pixel ray
   Color color = trace(_pixelRay, 0, 1);
@@ -290,19 +463,13 @@ RayTracer::trace(const Ray3f& ray, uint32_t level, float weight)
 {
   if (level > _maxRecursionLevel)
     return Color::black;
-  ++_numberOfRays;
+  ++(level == 0 ? _telemetry.primaryRays : _telemetry.reflectionRays);
 
   Intersection hit;
 
   return intersect(ray, hit) ? shade(ray, hit, level, weight) : background();
 }
 
-inline constexpr auto
-rt_eps()
-{
-  return 1e-4f;
-}
-
 bool
 RayTracer::intersect(const Ray3f& ray, Intersection& hit)
 //[]---------------------------------------------------[]
@@ -314,13 +481,7 @@ RayTracer::intersect(const Ray3f& ray, Intersection& hit)
 {
   hit.object = nullptr;
   hit.distance = ray.tMax;
-  return _bvh->intersect(ray, hit) ? ++_numberOfHits : false;
-}
-
-inline auto
-maxRGB(const Color& c)
-{
-  return math::max(math::max(c.r, c.g), c.b);
+  return _bvh->intersect(ray, hit) ? ++_telemetry.hits : false;
 }
 
 Color
@@ -355,50 +516,73 @@ RayTracer::shade(const Ray3f& ray,
   auto color = _scene->ambientLight * m->ambient;
   auto P = ray(hit.distance);
 
-  // Compute direct lighting
-  for (auto& light : _scene->lights())
+  // Compute direct lighting from the lights that can reach P
+  if (_simdShading)
   {
-    // If the light is turned off, then continue
-    if (!light->isTurnedOn())
-      continue;
+    PhongBatch batch;
+    PhongSample s;
 
-    vec3f L;
-    float d;
+    batch.add(P, N, R, *m);
+    _lights->iterateIndices(P, [&](uint32_t l)
+    {
+      phongShade(batch, _lightData, l, s, 1);
+      if (s.mask == 0)
+        return;
+
+      auto L = s.L(0);
+      auto lightRay = Ray3f{P + L * rt_eps(), L};
+
+      lightRay.tMax = s.distance[0];
+      ++_telemetry.shadowRays;
+      // If the point P is shadowed, then continue
+      if (shadow(lightRay))
+        return;
+      color += s.diffuse(0);
+      color += s.spot(0);
+    });
+  }
+  else
+  {
+    _lights->iterate(P, [&](const Light& light)
+    {
+      vec3f L;
+      float d;
 
-    // If the point P is out of the light range (for finite
-    // point light or spotlight), then continue
-    if (!light->lightVector(P, L, d))
-      continue;
+      // If the point P is out of the light range (for finite
+      // point light or spotlight), then continue
+      if (!light.lightVector(P, L, d))
+        return;
 
-    auto NL = N.dot(L);
+      auto NL = N.dot(L);
 
-    // If light vector is backfaced, then continue
-    if (NL <= 0)
-      continue;
+      // If light vector is backfaced, then continue
+      if (NL <= 0)
+        return;
 
-    auto lightRay = Ray3f{P + L * rt_eps(), L};
+      auto lightRay = Ray3f{P + L * rt_eps(), L};
 
-    lightRay.tMax = d;
-    ++_numberOfRays;
-    // If the point P is shadowed, then continue
-    if (shadow(lightRay))
-      continue;
+      lightRay.tMax = d;
+      ++_telemetry.shadowRays;
+      // If the point P is shadowed, then continue
+      if (shadow(lightRay))
+        return;
 
-    auto lc = light->lightColor(d);
+      auto lc = light.lightColor(d);
 
-    color += lc * m->diffuse * NL;
-    if (m->shine <= 0 || (d = R.dot(L)) <= 0)
-      continue;
-    color += lc * m->spot * pow(d, m->shine);
+      color += lc * m->diffuse * NL;
+      if (m->shine <= 0 || (d = R.dot(L)) <= 0)
+        return;
+      color += lc * m->spot * pow(d, m->shine);
+    });
   }
   // Compute specular reflection
   if (m->specular != Color::black)
   {
     weight *= maxRGB(m->specular);
-    if (weight > _minWeight && level < _maxRecursionLevel)
+    if (auto f = reflect(weight, level, _sampleX, _sampleY); f > 0)
     {
       auto reflectionRay = Ray3f{P + R * rt_eps(), R};
-      color += m->specular * trace(reflectionRay, level + 1, weight);
+      color += m->specular * f * trace(reflectionRay, level + 1, weight * f);
     }
   }
   return color;
@@ -414,6 +598,32 @@ RayTracer::background() const
   return _scene->backgroundColor;
 }
 
+float
+RayTracer::reflect(float weight, uint32_t level, float x, float y)
+//[]---------------------------------------------------[]
+//|  Reflection ray termination                         |
+//|  @param weight of the reflection ray                |
+//|  @param recursion level                             |
+//|  @param x coordinate of the pixel sample            |
+//|  @param y coordinate of the pixel sample            |
+//|  @return weight factor of the ray, or 0 if the ray  |
+//|  must not be traced                                 |
+//[]---------------------------------------------------[]
+{
+  if (level >= _maxRecursionLevel)
+    return 0;
+
+  auto f = _termination->reflect({weight,
+    level,
+    _minWeight,
+    pathRandom(x, y, level)});
+
+  // Count the paths cut before the fixed threshold would cut them
+  if (f <= 0 && weight > _minWeight)
+    ++_telemetry.terminatedPaths;
+  return f;
+}
+
 bool
 RayTracer::shadow(const Ray3f& ray)
 //[]---------------------------------------------------[]
@@ -422,7 +632,7 @@ RayTracer::shadow(const Ray3f& ray)
 //|  @return true if the ray intersects an object       |
 //[]---------------------------------------------------[]
 {
-  return _bvh->intersect(ray) ? ++_numberOfHits : false;
+  return _bvh->intersect(ray) ? ++_telemetry.shadowHits : false;
 }
 
 } // end namespace cg
@@ -28,20 +28,60 @@
 // Class definition for simple ray tracer.
 //
 // Author: Paulo Pagliosa
-// Last revision: 07/02/2022
+// Last revision: 19/10/2026
 
 #ifndef __RayTracer_h
 #define __RayTracer_h
 
+#include "core/MonotonicArena.h"
 #include "geometry/Intersection.h"
 #include "graphics/Image.h"
+#include "graphics/LightBVH.h"
 #include "graphics/PrimitiveBVH.h"
 #include "graphics/Renderer.h"
+#include "PhongKernel.h"
+#include "RayQueue.h"
+#include "RenderTelemetry.h"
+#include "TerminationPolicy.h"
+#include <cstring>
 #include <map>
 
 namespace cg
 { // begin namespace cg
 
+inline constexpr auto
+rt_eps()
+{
+  return 1e-4f;
+}
+
+inline auto
+maxRGB(const Color& c)
+{
+  return math::max(math::max(c.r, c.g), c.b);
+}
+
+// Returns a uniform random number in [0,1) hashed from the position
+// of a pixel sample and a recursion level. Both pipelines therefore
+// make the same random decisions for a path.
+inline float
+pathRandom(float x, float y, uint32_t level)
+{
+  uint32_t bx, by;
+
+  memcpy(&bx, &x, sizeof bx);
+  memcpy(&by, &y, sizeof by);
+
+  auto h = bx * 0x9e3779b1u ^ by * 0x85ebca77u ^ (level + 1) * 0xc2b2ae3du;
+
+  h ^= h >> 16;
+  h *= 0x7feb352du;
+  h ^= h >> 15;
+  h *= 0x846ca68bu;
+  h ^= h >> 16;
+  return float(h >> 8) * (1.0f / (1 << 24));
+}
+
 
 /////////////////////////////////////////////////////////////////////
 //
@@ -50,8 +90,16 @@ namespace cg
 class RayTracer: public Renderer
 {
 public:
+  enum class Pipeline
+  {
+    Recursive,
+    Wavefront
+  };
+
   static constexpr auto minMinWeight = float(0.001);
   static constexpr auto maxMaxRecursionLevel = uint32_t(20);
+  static constexpr auto tileSize = 64;
+  static constexpr auto minPixelSampleBudget = 4;
 
   RayTracer(SceneBase&, Camera&);
 
@@ -75,12 +123,129 @@ public:
     _maxRecursionLevel = math::min(rl, maxMaxRecursionLevel);
   }
 
+  auto pipeline() const
+  {
+    return _pipeline;
+  }
+
+  void setPipeline(Pipeline pipeline)
+  {
+    _pipeline = pipeline;
+  }
+
+  /// Returns true if the wavefront pipeline sorts secondary rays.
+  auto raySorting() const
+  {
+    return _raySorting;
+  }
+
+  void setRaySorting(bool state)
+  {
+    _raySorting = state;
+  }
+
+  /// Returns true if the direct lighting is computed by phongShade().
+  auto simdShading() const
+  {
+    return _simdShading;
+  }
+
+  void setSimdShading(bool state)
+  {
+    _simdShading = state;
+  }
+
+  /**
+   *  Returns the contrast threshold of the adaptive supersampling. A
+   *  pixel quadrant is subdivided if, for any RGB channel, the contrast
+   *  (max - min) / (max + min) of its corner samples is greater than
+   *  the threshold times the channel weight (1, 0.75 and 1.5 for R, G
+   *  and B, respectively).
+   */
+  auto contrastThreshold() const
+  {
+    return _contrastThreshold;
+  }
+
+  void setContrastThreshold(float t)
+  {
+    _contrastThreshold = math::max(t, 0.0f);
+  }
+
+  /// Returns the maximum number of samples traced for a pixel.
+  auto pixelSampleBudget() const
+  {
+    return _pixelSampleBudget;
+  }
+
+  void setPixelSampleBudget(int n)
+  {
+    _pixelSampleBudget = math::max(n, minPixelSampleBudget);
+  }
+
+  /**
+   *  Returns the average number of samples per pixel traced for an
+   *  image. The samples a pixel does not use are left to the next ones.
+   */
+  auto frameSampleBudget() const
+  {
+    return _frameSampleBudget;
+  }
+
+  void setFrameSampleBudget(float n)
+  {
+    _frameSampleBudget = math::max(n, 1.0f);
+  }
+
+  auto terminationPolicy() const
+  {
+    return _termination;
+  }
+
+  /// Sets the termination policy (threshold, if null) of reflection rays.
+  void setTerminationPolicy(TerminationPolicy* policy)
+  {
+    _termination = policy != nullptr ? policy : new ThresholdTermination;
+  }
+
   void update() override;
   void render() override;
-  virtual void renderImage(Image&, float maxDepth);
+  virtual RenderTelemetry renderImage(Image&, float maxDepth);
+
+  /**
+   *  Renders the rectangle (x, y, w, h) of an image in place. The
+   *  camera mapping is the one of the whole image, thus the pixels
+   *  of the rectangle are the same as rendered by renderImage().
+   */
+  RenderTelemetry renderRegion(Image&,
+    int x,
+    int y,
+    int w,
+    int h,
+    float maxDepth = 0);
+
+  /**
+   *  Sets the camera mapping for an image and resets the telemetry.
+   *  Together with scan(), renders several regions of an image without
+   *  updating the BVHs for each one; update() must be invoked before.
+   */
+  void setImage(const Image&);
+  void scan(Image&, const Viewport&, float maxDepth = 0);
+
+  /**
+   *  Returns the telemetry of the rendering since the last invocation
+   *  of setImage(). The BVH counters are those of the calling thread,
+   *  which must be the one that did the rendering.
+   */
+  RenderTelemetry telemetry() const;
 
 private:
+  struct Wave;
+
   Reference<PrimitiveBVH> _bvh;
+  Reference<LightBVH> _lights;
+  Reference<TerminationPolicy> _termination;
+  PhongLightData _lightData;
   struct VRC
   {
     vec3f u;
@@ -90,26 +255,51 @@ private:
   } _vrc;
   float _minWeight;
   uint32_t _maxRecursionLevel;
-  uint64_t _numberOfRays;
-  uint64_t _numberOfHits;
+  Pipeline _pipeline{Pipeline::Recursive};
+  bool _raySorting{false};
+  bool _simdShading{false};
+  float _contrastThreshold{0.4f};
+  int _pixelSampleBudget{64};
+  float _frameSampleBudget{16};
+  RenderTelemetry _telemetry;
+  BVHStats _bvhSnapshot;
   Ray3f _pixelRay;
+  float _sampleX;
+  float _sampleY;
+  Viewport _tile;
   float _Vh;
   float _Vw;
   float _Ih;
   float _Iw;
   float _epsilon{ 0.2 };
 
-  std::map<std::pair<float, float>, Color> _rayMap;
+  using RayMapKey = std::pair<float, float>;
+  using RayMap = std::map<RayMapKey,
+    Color,
+    std::less<RayMapKey>,
+    ArenaAllocator<std::pair<const RayMapKey, Color>>>;
+
+  // The samples of a scan are cached in a map whose nodes are
+  // allocated in _rayMapArena, which is reset in every scan
+  MonotonicArena _rayMapArena;
+  RayMap _rayMap{RayMap::allocator_type{_rayMapArena}};
 
-  void scan(Image& image, float maxDepth);
   void setPixelRay(float x, float y);
+  void setPixelRay(Ray3f&, float x, float y) const;
   Color shoot(float x, float y);
   bool intersect(const Ray3f&, Intersection&);
   Color trace(const Ray3f& ray, uint32_t level, float weight);
   Color shade(const Ray3f&, Intersection&, uint32_t, float);
   bool shadow(const Ray3f&);
+  float reflect(float weight, uint32_t level, float x, float y);
   Color background() const;
-  Color supersampling(float minX, float maxX, float minY, float maxY, int depth, int maxDepth);
+  // Wavefront pipeline (see RayTracerWavefront.cpp)
+  void scanWavefront(Image&, const Viewport&);
+  void traceTile(int x, int y, int w, int h, ImageBuffer&);
+  void intersect(const RayQueue&, Wave&);
+  void shade(const RayQueue&, Wave&, uint32_t, ShadowRayQueue&, RayQueue&);
+  void shadow(const ShadowRayQueue&, Wave&);
+  Color supersample(int x, int y, int maxDepth, int budget);
   vec3f imageToWindow(float x, float y) const
   {
     return _Vw * (x * _Iw - 0.5f) * _vrc.u + _Vh * (y * _Ih - 0.5f) * _vrc.v;
@@ -0,0 +1,388 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2026 Paulo Pagliosa.                              |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: RayTracerWavefront.cpp
+// ========
+// Source file for the wavefront pipeline of the simple ray tracer.
+//
+// Author: Paulo Pagliosa
+// Last revision: 19/10/2026
+
+#include "RayTracer.h"
+#include <algorithm>
+
+namespace cg
+{ // begin namespace cg
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// RayTracer wavefront pipeline
+// =========
+//
+// The rays of a tile are processed level by level. At each level
+// (wave), all rays of the queue are intersected in bulk, the hits
+// are sorted by material and shaded in bulk, and the shadow and
+// reflection rays spawned by the shading are pushed into the shadow
+// queue and the queue of the next wave, respectively. Reflection rays
+// are sorted by direction octant and origin Morton code before being
+// intersected (see RayQueue::sort()). Optionally, the direct lighting
+// of the hits is computed in batches by phongShade(). When no ray
+// is left, the colors of the waves are combined from the deepest
+// wave up to the primary one, exactly as the recursive tracer does.
+//
+struct RayTracer::Wave
+{
+  enum State: uint8_t
+  {
+    Miss,
+    Hit,
+    Reflected
+  };
+
+  std::vector<uint32_t> path;
+  std::vector<uint8_t> state;
+  std::vector<Intersection> hit;
+  std::vector<uint32_t> hits; // ids of the rays that hit an object
+  std::vector<Color> color; // local color of each ray
+  std::vector<Color> specular; // weight of the reflected color
+
+  void reset(const RayQueue& queue)
+  {
+    auto n = queue.size();
+
+    path = queue.path;
+    state.assign(n, Miss);
+    hit.resize(n);
+    hits.clear();
+    color.resize(n);
+    specular.resize(n);
+  }
+
+}; // RayTracer::Wave
+
+void
+RayTracer::scanWavefront(Image& image, const Viewport& region)
+{
+  auto nx = (region.w + tileSize - 1) / tileSize;
+  auto ny = (region.h + tileSize - 1) / tileSize;
+  auto nt = nx * ny;
+
+  for (auto t = 0; t < nt; ++t)
+  {
+    auto x = t % nx * tileSize;
+    auto y = t / nx * tileSize;
+    auto w = math::min(tileSize, region.w - x);
+    auto h = math::min(tileSize, region.h - y);
+    ImageBuffer tile{w, h};
+
+    x += region.x;
+    y += region.y;
+
+    printf("Scanning tile %d of %d\r", t + 1, nt);
+    _termination->beginPixels(w * h);
+    traceTile(x, y, w, h, tile);
+    image.setData(x, y, tile);
+  }
+}
+
+void
+RayTracer::traceTile(int x, int y, int w, int h, ImageBuffer& tile)
+//[]---------------------------------------------------[]
+//|  Trace the pixel rays of a tile                     |
+//|  @param x coordinate of the tile                    |
+//|  @param y coordinate of the tile                    |
+//|  @param width of the tile                           |
+//|  @param height of the tile                          |
+//|  @param tile pixels (output)                        |
+//[]---------------------------------------------------[]
+{
+  auto np = uint32_t(w * h);
+  std::vector<Wave> waves;
+  RayQueue queue;
+  RayQueue next;
+  ShadowRayQueue shadowQueue;
+  auto bounds = _bvh->bounds();
+
+  _tile = {x, y, w, h};
+
+  // Generate the primary rays
+  queue.reserve(np);
+  for (auto j = 0; j < h; ++j)
+    for (auto i = 0; i < w; ++i)
+    {
+      auto ray = _pixelRay;
+
+      setPixelRay(ray, float(x + i) + 0.5f, float(y + j) + 0.5f);
+      queue.push(ray, j * w + i);
+    }
+  for (uint32_t level = 0; !queue.empty(); ++level)
+  {
+    auto& wave = waves.emplace_back();
+
+    (level == 0 ? _telemetry.primaryRays : _telemetry.reflectionRays) +=
+      queue.size();
+    intersect(queue, wave);
+    next.clear();
+    shadowQueue.clear();
+    shade(queue, wave, level, shadowQueue, next);
+    shadow(shadowQueue, wave);
+    // Make the reflection rays coherent before intersecting them
+    if (_raySorting && next.size() > 1)
+      next.sort(bounds);
+    queue.swap(next);
+  }
+
+  // Combine the wave colors from the deepest level up
+  std::vector<Color> color(np, Color::black);
+
+  for (auto l = waves.size(); l-- > 0;)
+  {
+    const auto& wave = waves[l];
+
+    for (uint32_t i = 0, n = (uint32_t)wave.path.size(); i < n; ++i)
+    {
+      auto& c = color[wave.path[i]];
+
+      switch (wave.state[i])
+      {
+        case Wave::Miss:
+          c = background();
+          break;
+
+        case Wave::Hit:
+          c = wave.color[i];
+          break;
+
+        case Wave::Reflected:
+          c = wave.color[i] + wave.specular[i] * c;
+          break;
+      }
+    }
+  }
+  for (uint32_t i = 0; i < np; ++i)
+  {
+    auto& c = color[i];
+
+    // adjust RGB color
+    if (c.r > 1.0f)
+      c.r = 1.0f;
+    if (c.g > 1.0f)
+      c.g = 1.0f;
+    if (c.b > 1.0f)
+      c.b = 1.0f;
+    tile[i] = c;
+  }
+}
+
+void
+RayTracer::intersect(const RayQueue& queue, Wave& wave)
+//[]---------------------------------------------------[]
+//|  Intersect a queue of rays                          |
+//|  @param the ray queue (input)                       |
+//|  @param the wave (output)                           |
+//[]---------------------------------------------------[]
+{
+  wave.reset(queue);
+  for (uint32_t i = 0, n = queue.size(); i < n; ++i)
+  {
+    if (intersect(queue.ray(i), wave.hit[i]))
+    {
+      wave.state[i] = Wave::Hit;
+      wave.hits.push_back(i);
+    }
+  }
+
+  // Sort the hits by material
+  auto& hit = wave.hit;
+
+  std::sort(wave.hits.begin(), wave.hits.end(), [&hit](uint32_t a, uint32_t b)
+  {
+    auto ma = ((Primitive*)hit[a].object)->material();
+    auto mb = ((Primitive*)hit[b].object)->material();
+
+    return ma != mb ? ma < mb : a < b;
+  });
+}
+
+void
+RayTracer::shade(const RayQueue& queue,
+  Wave& wave,
+  uint32_t level,
+  ShadowRayQueue& shadowQueue,
+  RayQueue& next)
+//[]---------------------------------------------------[]
+//|  Shade the hits of a wave                           |
+//|  @param the ray queue (input)                       |
+//|  @param the wave (input/output)                     |
+//|  @param recursion level                             |
+//|  @param shadow rays (output)                        |
+//|  @param reflection rays (output)                    |
+//[]---------------------------------------------------[]
+{
+  PhongBatch batch;
+  PhongSample sample;
+  uint32_t ids[PhongBatch::size];
+  // Lanes of the batch at which each light can incide
+  std::vector<uint32_t> lanes(_lightData.size());
+  std::vector<uint32_t> batchLights;
+
+  // Push a shadow ray for each light that can reach each hit of the
+  // batch, in light order for every hit
+  auto shadeBatch = [&]()
+  {
+    for (uint32_t k = 0; k < batch.count; ++k)
+    {
+      vec3f P{batch.px[k], batch.py[k], batch.pz[k]};
+
+      _lights->iterateIndices(P, [&](uint32_t l)
+      {
+        if (lanes[l] == 0)
+          batchLights.push_back(l);
+        lanes[l] |= 1u << k;
+      });
+    }
+    std::sort(batchLights.begin(), batchLights.end());
+    for (auto l : batchLights)
+    {
+      phongShade(batch, _lightData, l, sample, lanes[l]);
+      lanes[l] = 0;
+      for (uint32_t k = 0; k < batch.count; ++k)
+        if (sample.mask & 1u << k)
+        {
+          vec3f P{batch.px[k], batch.py[k], batch.pz[k]};
+          auto L = sample.L(k);
+          auto lightRay = Ray3f{P + L * rt_eps(), L};
+
+          lightRay.tMax = sample.distance[k];
+          ++_telemetry.shadowRays;
+          shadowQueue.push(lightRay,
+            ids[k],
+            sample.diffuse(k),
+            sample.spot(k));
+        }
+    }
+    batchLights.clear();
+    batch.clear();
+  };
+
+  for (auto i : wave.hits)
+  {
+    const auto ray = queue.ray(i);
+    auto& hit = wave.hit[i];
+    auto primitive = (Primitive*)hit.object;
+    auto N = primitive->normal(hit);
+    const auto& V = ray.direction;
+    auto NV = N.dot(V);
+
+    // Make sure "real" normal is on right side
+    if (NV > 0)
+      N.negate(), NV = -NV;
+
+    auto R = V - (2 * NV) * N; // reflection vector
+    // Start with ambient lighting
+    auto m = primitive->material();
+    auto P = ray(hit.distance);
+
+    wave.color[i] = _scene->ambientLight * m->ambient;
+    if (_simdShading)
+    {
+      ids[batch.add(P, N, R, *m)] = i;
+      if (batch.full())
+        shadeBatch();
+    }
+    else
+    {
+      // Push a shadow ray for each light that can reach P
+      _lights->iterate(P, [&](const Light& light)
+      {
+        vec3f L;
+        float d;
+
+        if (!light.lightVector(P, L, d))
+          return;
+
+        auto NL = N.dot(L);
+
+        if (NL <= 0)
+          return;
+
+        auto lightRay = Ray3f{P + L * rt_eps(), L};
+
+        lightRay.tMax = d;
+        ++_telemetry.shadowRays;
+
+        auto lc = light.lightColor(d);
+        auto diffuse = lc * m->diffuse * NL;
+        auto spot = Color::black;
+
+        if (m->shine > 0 && (d = R.dot(L)) > 0)
+          spot = lc * m->spot * pow(d, m->shine);
+        shadowQueue.push(lightRay, i, diffuse, spot);
+      });
+    }
+    // Push the reflection ray
+    if (m->specular != Color::black)
+    {
+      auto weight = queue.weight[i] * maxRGB(m->specular);
+      auto p = int(queue.path[i]);
+      auto f = reflect(weight,
+        level,
+        float(_tile.x + p % _tile.w) + 0.5f,
+        float(_tile.y + p / _tile.w) + 0.5f);
+
+      if (f > 0)
+      {
+        wave.state[i] = Wave::Reflected;
+        wave.specular[i] = m->specular * f;
+        next.push(Ray3f{P + R * rt_eps(), R}, queue.path[i], weight * f);
+      }
+    }
+  }
+  if (batch.count > 0)
+    shadeBatch();
+}
+
+void
+RayTracer::shadow(const ShadowRayQueue& queue, Wave& wave)
+//[]---------------------------------------------------[]
+//|  Intersect a queue of shadow rays                   |
+//|  @param the shadow ray queue (input)                |
+//|  @param the wave (input/output)                     |
+//[]---------------------------------------------------[]
+{
+  // Shadow rays of a hit are in light order, thus the direct
+  // lighting terms are added as in the recursive tracer
+  for (uint32_t i = 0, n = queue.size(); i < n; ++i)
+    if (!shadow(queue.ray(i)))
+    {
+      auto& c = wave.color[queue.path[i]];
+
+      c += queue.diffuse[i];
+      c += queue.spot[i];
+    }
+}
+
+} // end namespace cg
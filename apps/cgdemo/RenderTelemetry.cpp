@@ -0,0 +1,95 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2026 Paulo Pagliosa.                              |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: RenderTelemetry.cpp
+// ========
+// Source file for render telemetry.
+//
+// Author: Paulo Pagliosa
+// Last revision: 19/10/2026
+
+#include "RenderTelemetry.h"
+#include <cstdio>
+
+namespace cg
+{ // begin namespace cg
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// RenderTelemetry implementation
+// ===============
+RenderTelemetry&
+RenderTelemetry::operator +=(const RenderTelemetry& t)
+{
+  primaryRays += t.primaryRays;
+  shadowRays += t.shadowRays;
+  reflectionRays += t.reflectionRays;
+  hits += t.hits;
+  shadowHits += t.shadowHits;
+  samples += t.samples;
+  nodeVisits += t.nodeVisits;
+  primitiveTests += t.primitiveTests;
+  triangleTests += t.triangleTests;
+  terminatedPaths += t.terminatedPaths;
+  return *this;
+}
+
+std::string
+RenderTelemetry::toJSON() const
+{
+  char buffer[1024];
+  auto u = [](uint64_t n) { return (unsigned long long)n; };
+
+  snprintf(buffer, sizeof buffer,
+    "{\"rays\":{\"primary\":%llu,\"shadow\":%llu,\"reflection\":%llu,"
+    "\"total\":%llu},"
+    "\"hits\":%llu,\"shadowHits\":%llu,\"samples\":%llu,"
+    "\"bvh\":{\"nodeVisits\":%llu,\"primitiveTests\":%llu,"
+    "\"triangleTests\":%llu},"
+    "\"termination\":{\"policy\":\"%s\",\"terminatedPaths\":%llu},"
+    "\"timeMs\":{\"update\":%.3f,\"scan\":%.3f,\"display\":%.3f},"
+    "\"raysPerSecond\":%.0f,\"workers\":%d}",
+    u(primaryRays),
+    u(shadowRays),
+    u(reflectionRays),
+    u(rays()),
+    u(hits),
+    u(shadowHits),
+    u(samples),
+    u(nodeVisits),
+    u(primitiveTests),
+    u(triangleTests),
+    termination != nullptr ? termination : "",
+    u(terminatedPaths),
+    updateTime,
+    scanTime,
+    displayTime,
+    raysPerSecond(),
+    workers);
+  return buffer;
+}
+
+} // end namespace cg
@@ -0,0 +1,98 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2026 Paulo Pagliosa.                              |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: RenderTelemetry.h
+// ========
+// Class definition for render telemetry.
+//
+// Author: Paulo Pagliosa
+// Last revision: 19/10/2026
+
+#ifndef __RenderTelemetry_h
+#define __RenderTelemetry_h
+
+#include "geometry/BVH.h"
+#include <string>
+
+namespace cg
+{ // begin namespace cg
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// RenderTelemetry: render telemetry class
+// ===============
+//
+// Counters and phase times of a render. The counters of a render
+// are collected by the thread (or process) that does it, without any
+// synchronization, and the telemetry of several threads is merged
+// with operator +=. The times are in milliseconds.
+//
+struct RenderTelemetry
+{
+  uint64_t primaryRays;
+  uint64_t shadowRays;
+  uint64_t reflectionRays;
+  uint64_t hits; // primary and reflection rays that hit an object
+  uint64_t shadowHits; // shadow rays blocked by an object
+  uint64_t samples; // pixel samples shot by the recursive pipeline
+  uint64_t nodeVisits;
+  uint64_t primitiveTests;
+  uint64_t triangleTests;
+  const char* termination; // name of the termination policy
+  uint64_t terminatedPaths; // paths cut before the fixed threshold
+  double updateTime; // BVH update
+  double scanTime;
+  double displayTime;
+  int workers;
+
+  auto rays() const
+  {
+    return primaryRays + shadowRays + reflectionRays;
+  }
+
+  auto raysPerSecond() const
+  {
+    return scanTime > 0 ? rays() * 1000 / scanTime : 0.0;
+  }
+
+  /// Adds the counters of t to this object; the times are kept.
+  RenderTelemetry& operator +=(const RenderTelemetry& t);
+
+  /// Sets the BVH counters to the traversals done since a snapshot.
+  void setBVHStats(const BVHStats& current, const BVHStats& snapshot)
+  {
+    nodeVisits = current.nodeVisits - snapshot.nodeVisits;
+    primitiveTests = current.primitiveTests - snapshot.primitiveTests;
+    triangleTests = current.triangleTests - snapshot.triangleTests;
+  }
+
+  std::string toJSON() const;
+
+}; // RenderTelemetry
+
+} // end namespace cg
+
+#endif // __RenderTelemetry_h
@@ -0,0 +1,149 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2026 Paulo Pagliosa.                              |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: TerminationPolicy.cpp
+// ========
+// Source file for ray termination policies.
+//
+// Author: Paulo Pagliosa
+// Last revision: 19/10/2026
+
+#include "math/Real.h"
+#include "TerminationPolicy.h"
+#include <algorithm>
+#include <cmath>
+
+namespace cg
+{ // begin namespace cg
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// TerminationPolicy implementation
+// =================
+void
+TerminationPolicy::start(uint64_t)
+{
+  // do nothing
+}
+
+void
+TerminationPolicy::beginPixels(uint32_t)
+{
+  // do nothing
+}
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// ThresholdTermination implementation
+// ====================
+const char*
+ThresholdTermination::name() const
+{
+  return "threshold";
+}
+
+float
+ThresholdTermination::reflect(const ReflectionInfo& r)
+{
+  return r.weight > r.minWeight ? 1.0f : 0.0f;
+}
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// RussianRoulette implementation
+// ===============
+const char*
+RussianRoulette::name() const
+{
+  return "russianRoulette";
+}
+
+float
+RussianRoulette::reflect(const ReflectionInfo& r)
+{
+  if (r.level < _startLevel)
+    return 1;
+
+  auto p = math::min(r.weight / _threshold, _maxSurvival);
+
+  return r.u < p ? math::inverse(p) : 0.0f;
+}
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// RayBudgetTermination implementation
+// ====================
+const char*
+RayBudgetTermination::name() const
+{
+  return "rayBudget";
+}
+
+void
+RayBudgetTermination::start(uint64_t pixelCount)
+{
+  _threshold = 0;
+  _raysLeft = double(_raysPerPixel) * pixelCount;
+  _pixelsLeft = pixelCount;
+  _pixelsDone = 0;
+  std::fill_n(_histogram, binCount, 0);
+}
+
+void
+RayBudgetTermination::beginPixels(uint32_t n)
+{
+  if (_pixelsDone > 0 && _pixelsLeft > 0)
+  {
+    // Rays that can be requested by the pixels done
+    auto rays = math::max(_raysLeft, 0.0) / _pixelsLeft * _pixelsDone;
+    uint64_t count = 0;
+    auto i = 0;
+
+    while (i < binCount && (count += _histogram[i]) <= rays)
+      ++i;
+    _threshold = i < binCount ? exp2f(-(i + 1) / 8.0f) : 0;
+  }
+  n = (uint32_t)math::min<uint64_t>(n, _pixelsLeft);
+  _pixelsLeft -= n;
+  _pixelsDone += n;
+}
+
+float
+RayBudgetTermination::reflect(const ReflectionInfo& r)
+{
+  auto i = r.weight >= 1 ? 0 : int(-8 * log2f(r.weight));
+
+  ++_histogram[math::min(i, binCount - 1)];
+  if (r.weight <= r.minWeight || r.weight <= _threshold)
+    return 0;
+  _raysLeft -= 1;
+  return 1;
+}
+
+} // end namespace cg
@@ -0,0 +1,185 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2026 Paulo Pagliosa.                              |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: TerminationPolicy.h
+// ========
+// Class definition for ray termination policies.
+//
+// Author: Paulo Pagliosa
+// Last revision: 19/10/2026
+
+#ifndef __TerminationPolicy_h
+#define __TerminationPolicy_h
+
+#include "core/SharedObject.h"
+#include <cinttypes>
+
+namespace cg
+{ // begin namespace cg
+
+// Reflection ray to be traced or not by a ray tracer
+struct ReflectionInfo
+{
+  float weight; // weight of the ray
+  uint32_t level; // recursion level of the hit that spawns the ray
+  float minWeight; // minimum weight of the ray tracer
+  float u; // uniform random number in [0,1) of the path
+
+}; // ReflectionInfo
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// TerminationPolicy: ray termination policy class
+// =================
+//
+// Decides which reflection rays are traced. The maximum recursion
+// level of the ray tracer is always enforced by the ray tracer itself.
+//
+class TerminationPolicy: public SharedObject
+{
+public:
+  virtual const char* name() const = 0;
+
+  /// Invoked before the pixels of an image are scanned.
+  virtual void start(uint64_t pixelCount);
+
+  /// Invoked before n more pixels of the image are traced.
+  virtual void beginPixels(uint32_t n);
+
+  /**
+   *  Returns 0 if a reflection ray must not be traced, or the factor
+   *  by which the weight and the color of the ray are multiplied,
+   *  otherwise.
+   */
+  virtual float reflect(const ReflectionInfo&) = 0;
+
+}; // TerminationPolicy
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// ThresholdTermination: fixed weight threshold policy class
+// ====================
+//
+// Traces the rays whose weight is greater than the minimum weight of
+// the ray tracer.
+//
+class ThresholdTermination final: public TerminationPolicy
+{
+public:
+  const char* name() const override;
+  float reflect(const ReflectionInfo&) override;
+
+}; // ThresholdTermination
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// RussianRoulette: Russian roulette policy class
+// ===============
+//
+// From the start level on, a ray of weight w survives with probability
+// p = min(w / threshold, maxSurvival) and its weight and color are
+// divided by p. The expected color of a pixel is thus the one with no
+// termination at all (but for the maximum recursion level), whereas
+// paths between facing mirrors, whose weight hardly decreases, are
+// cut after 1 / (1 - maxSurvival) bounces on average.
+//
+class RussianRoulette final: public TerminationPolicy
+{
+public:
+  RussianRoulette(float threshold = 0.25f,
+    uint32_t startLevel = 4,
+    float maxSurvival = 0.9f):
+    _threshold{threshold},
+    _startLevel{startLevel},
+    _maxSurvival{maxSurvival}
+  {
+    // do nothing
+  }
+
+  const char* name() const override;
+  float reflect(const ReflectionInfo&) override;
+
+private:
+  float _threshold;
+  uint32_t _startLevel;
+  float _maxSurvival;
+
+}; // RussianRoulette
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// RayBudgetTermination: per-frame ray budget policy class
+// ====================
+//
+// Traces about raysPerPixel reflection rays per pixel of an image on
+// average, spending the budget on the heaviest rays. Since the weight
+// of a ray is not greater than the one of its parent, the number of
+// rays traced with a weight threshold t is the number of rays whose
+// weight is greater than t. The policy keeps a histogram of the
+// weights of the rays requested so far and, before each group of
+// pixels (a pixel in the recursive pipeline, a tile in the wavefront
+// one), sets t to the lowest weight for which the rays requested per
+// pixel fit the rays left per pixel left. The minimum weight of the
+// ray tracer is also enforced.
+//
+class RayBudgetTermination final: public TerminationPolicy
+{
+public:
+  RayBudgetTermination(float raysPerPixel = 2):
+    _raysPerPixel{raysPerPixel}
+  {
+    // do nothing
+  }
+
+  auto raysPerPixel() const
+  {
+    return _raysPerPixel;
+  }
+
+  const char* name() const override;
+  void start(uint64_t pixelCount) override;
+  void beginPixels(uint32_t n) override;
+  float reflect(const ReflectionInfo&) override;
+
+private:
+  // Bin i holds the weights in (2^-(i+1)/8, 2^-i/8]
+  static constexpr auto binCount = 128;
+
+  float _raysPerPixel;
+  float _threshold{};
+  double _raysLeft{};
+  uint64_t _pixelsLeft{};
+  uint64_t _pixelsDone{};
+  uint64_t _histogram[binCount];
+
+}; // RayBudgetTermination
+
+} // end namespace cg
+
+#endif // __TerminationPolicy_h
@@ -0,0 +1,267 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2026 Paulo Pagliosa.                              |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: TileRenderer.cpp
+// ========
+// Source file for multi-process tile renderer.
+//
+// Author: Paulo Pagliosa
+// Last revision: 19/10/2026
+
+#include "utils/Stopwatch.h"
+#include "TileRenderer.h"
+#ifdef __linux__
+#include <atomic>
+#include <cstring>
+#include <new>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif // __linux__
+
+namespace cg
+{ // begin namespace cg
+
+#ifdef __linux__
+
+namespace
+{ // begin namespace
+
+enum TileState: uint8_t
+{
+  Pending,
+  Claimed,
+  Done
+};
+
+using AtomicState = std::atomic<uint8_t>;
+
+// Header of the shared memory block, followed by the tile states and
+// by the framebuffer pixels. Each worker writes its telemetry into its
+// own slot when done.
+struct SharedFrame
+{
+  std::atomic<uint32_t> nextTile;
+  RenderTelemetry telemetry[TileRenderer::maxWorkerCount];
+
+}; // SharedFrame
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free &&
+  AtomicState::is_always_lock_free,
+  "TileRenderer: lock-free atomics required in shared memory");
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// SharedImage: image in shared memory class
+// ===========
+class SharedImage final: public Image
+{
+public:
+  SharedImage(int width, int height, Pixel* pixels):
+    Image{width, height},
+    _pixels{pixels}
+  {
+    // do nothing
+  }
+
+  void draw(int, int) const override
+  {
+    // do nothing
+  }
+
+private:
+  Pixel* _pixels;
+
+  void setSubImage(int x, int y, int w, int h, const Pixel* data) override
+  {
+    for (auto j = 0; j < h; ++j)
+      memcpy(_pixels + size_t(y + j) * _W + x,
+        data + size_t(j) * w,
+        w * sizeof(Pixel));
+  }
+
+  void getSubImage(int x, int y, int w, int h, Pixel* data) const override
+  {
+    for (auto j = 0; j < h; ++j)
+      memcpy(data + size_t(j) * w,
+        _pixels + size_t(y + j) * _W + x,
+        w * sizeof(Pixel));
+  }
+
+}; // SharedImage
+
+inline Viewport
+tileViewport(uint32_t tile, int nx, int width, int height)
+{
+  constexpr auto ts = RayTracer::tileSize;
+  auto x = int(tile % nx) * ts;
+  auto y = int(tile / nx) * ts;
+
+  return {x, y, math::min(ts, width - x), math::min(ts, height - y)};
+}
+
+void
+work(int id,
+  RayTracer& rayTracer,
+  SharedFrame& frame,
+  AtomicState* states,
+  SharedImage& image,
+  uint32_t tileCount,
+  int nx,
+  float maxDepth)
+{
+  // Silence the progress messages of the worker
+  if (auto fd = open("/dev/null", O_WRONLY); fd >= 0)
+    dup2(fd, STDOUT_FILENO);
+  for (;;)
+  {
+    auto t = frame.nextTile++;
+
+    if (t >= tileCount)
+      break;
+    states[t] = Claimed;
+    rayTracer.scan(image,
+      tileViewport(t, nx, image.width(), image.height()),
+      maxDepth);
+    states[t] = Done;
+  }
+  frame.telemetry[id] = rayTracer.telemetry();
+}
+
+} // end namespace
+
+#endif // __linux__
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// TileRenderer implementation
+// ============
+RenderTelemetry
+TileRenderer::renderImage(Image& image, float maxDepth)
+{
+  _recoveredTileCount = 0;
+#ifdef __linux__
+  constexpr auto ts = RayTracer::tileSize;
+  auto w = image.width();
+  auto h = image.height();
+  auto nx = (w + ts - 1) / ts;
+  auto tileCount = uint32_t(nx * ((h + ts - 1) / ts));
+  auto stateOffset = sizeof(SharedFrame);
+  auto pixelOffset = (stateOffset + tileCount + 15) & ~size_t(15);
+  auto size = pixelOffset + size_t(w) * h * sizeof(Pixel);
+  auto memory = _workerCount > 0 ?
+    mmap(nullptr,
+      size,
+      PROT_READ | PROT_WRITE,
+      MAP_SHARED | MAP_ANONYMOUS,
+      -1,
+      0) :
+    MAP_FAILED;
+
+  if (memory == MAP_FAILED)
+    return _rayTracer->renderImage(image, maxDepth);
+
+  auto base = (char*)memory;
+  auto frame = new (base) SharedFrame{};
+  auto states = (AtomicState*)(base + stateOffset);
+
+  for (uint32_t t = 0; t < tileCount; ++t)
+    new (states + t) AtomicState{Pending};
+
+  SharedImage framebuffer{w, h, (Pixel*)(base + pixelOffset)};
+  Stopwatch timer;
+
+  // The workers inherit the BVHs built by the coordinator
+  timer.start();
+  _rayTracer->update();
+
+  auto updateTime = timer.lap();
+
+  _rayTracer->setImage(framebuffer);
+  fflush(stdout);
+
+  pid_t workers[maxWorkerCount];
+  auto workerCount = 0;
+
+  for (auto i = 0; i < _workerCount; ++i)
+    if (auto pid = fork(); pid == 0)
+    {
+      work(i,
+        *_rayTracer,
+        *frame,
+        states,
+        framebuffer,
+        tileCount,
+        nx,
+        maxDepth);
+      _exit(0);
+    }
+    else if (pid > 0)
+      workers[workerCount++] = pid;
+  for (auto i = 0; i < workerCount; ++i)
+    waitpid(workers[i], nullptr, 0);
+  // Render the tiles not finished by the workers, if any
+  for (uint32_t t = 0; t < tileCount; ++t)
+    if (states[t] != Done)
+    {
+      _rayTracer->scan(framebuffer, tileViewport(t, nx, w, h), maxDepth);
+      ++_recoveredTileCount;
+    }
+
+  ImageBuffer buffer{w, h};
+  auto pixels = (const Pixel*)(base + pixelOffset);
+
+  for (auto i = 0, n = w * h; i < n; ++i)
+    buffer[i] = pixels[i];
+  image.setData(buffer);
+
+  // Merge the telemetry of the coordinator and of the workers; the
+  // slot of a worker that crashed is left zeroed
+  auto t = _rayTracer->telemetry();
+
+  for (auto i = 0; i < _workerCount; ++i)
+    t += frame->telemetry[i];
+  t.updateTime = updateTime;
+  t.scanTime = timer.lap();
+  t.workers = workerCount;
+  printf("\nNumber of workers: %d", workerCount);
+  printf("\nNumber of tiles: %u (%d recovered)",
+    tileCount,
+    _recoveredTileCount);
+  printf("\nNumber of rays: %llu", (unsigned long long)t.rays());
+  printf("\nNumber of hits: %llu",
+    (unsigned long long)(t.hits + t.shadowHits));
+  printf("\nDONE! Elapsed time: %g ms\n", t.scanTime);
+  munmap(memory, size);
+  return t;
+#else
+  return _rayTracer->renderImage(image, maxDepth);
+#endif // __linux__
+}
+
+} // end namespace cg
@@ -0,0 +1,94 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2026 Paulo Pagliosa.                              |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: TileRenderer.h
+// ========
+// Class definition for multi-process tile renderer.
+//
+// Author: Paulo Pagliosa
+// Last revision: 19/10/2026
+
+#ifndef __TileRenderer_h
+#define __TileRenderer_h
+
+#include "RayTracer.h"
+
+namespace cg
+{ // begin namespace cg
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// TileRenderer: multi-process tile renderer class
+// ============
+//
+// Splits the rendering of an image into tiles traced by a number of
+// worker processes forked from the calling one, which therefore share
+// the scene and the BVHs already built by the coordinator. The tiles
+// are written into a framebuffer in shared memory and handed out on
+// demand, so a worker that finishes early keeps taking tiles from the
+// others. Tiles left unfinished by a worker that crashed are rendered
+// by the coordinator. The workers run on Linux only; elsewhere, or if
+// the number of workers is zero, the image is rendered in-process.
+//
+class TileRenderer
+{
+public:
+  static constexpr auto maxWorkerCount = 64;
+
+  TileRenderer(RayTracer& rayTracer, int workerCount = 4):
+    _rayTracer{&rayTracer}
+  {
+    setWorkerCount(workerCount);
+  }
+
+  auto workerCount() const
+  {
+    return _workerCount;
+  }
+
+  void setWorkerCount(int n)
+  {
+    _workerCount = math::clamp(n, 0, maxWorkerCount);
+  }
+
+  /// Returns the number of tiles rendered by the coordinator.
+  auto recoveredTileCount() const
+  {
+    return _recoveredTileCount;
+  }
+
+  RenderTelemetry renderImage(Image&, float maxDepth = 0);
+
+private:
+  Reference<RayTracer> _rayTracer;
+  int _workerCount;
+  int _recoveredTileCount{};
+
+}; // TileRenderer
+
+} // end namespace cg
+
+#endif // __TileRenderer_h
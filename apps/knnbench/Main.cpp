@@ -0,0 +1,127 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2026 Paulo Pagliosa.                              |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: Main.cpp
+// ========
+// Microbenchmark of the k-nearest neighbor searches. Times each point
+// search with the inlined knn::SquaredNorm policy and with the type-erased
+// KNNHelper::Norm (std::function) norm.
+//
+// Usage: knnbench [points [k...]]
+//
+// Author: Paulo Pagliosa
+// Last revision: 19/10/2026
+
+#include "geometry/LinearPointTree.h"
+#include "geometry/PointGrid3.h"
+#include "geometry/PointOctree.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+using namespace cg;
+
+namespace
+{ // begin namespace
+
+using Points = std::vector<vec3f>;
+using Clock = std::chrono::steady_clock;
+
+constexpr auto queryStride = 5;
+
+template <typename Search, typename Norm>
+long
+timeQueries(const Search& s, const Points& points, int k, Norm norm)
+{
+  std::vector<int> index(k);
+  std::vector<float> distance(k);
+  volatile float sum = 0;
+  auto start = Clock::now();
+
+  for (size_t i = 0; i < points.size(); i += queryStride)
+  {
+    s.findNearestNeighbors(points[i],
+      k,
+      index.data(),
+      distance.data(),
+      norm);
+    sum = sum + distance[0];
+  }
+
+  using namespace std::chrono;
+  return (long)duration_cast<milliseconds>(Clock::now() - start).count();
+}
+
+template <typename Search>
+void
+bench(const char* name, const Search& s, const Points& points, int k)
+{
+  KNNHelper<vec3f>::Norm erased{KNNHelper<vec3f>::squaredNorm};
+  auto policy = timeQueries(s, points, k, knn::SquaredNorm{});
+  auto function = timeQueries(s, points, k, erased);
+
+  printf("%-12s k=%-3d policy %6ld ms  std::function %6ld ms\n",
+    name,
+    k,
+    policy,
+    function);
+}
+
+} // end namespace
+
+int
+main(int argc, char** argv)
+{
+  auto n = argc > 1 ? atoi(argv[1]) : 200000;
+  std::vector<int> ks;
+
+  for (int i = 2; i < argc; ++i)
+    ks.push_back(atoi(argv[i]));
+  if (ks.empty())
+    ks = {8, 32};
+
+  Points points(n);
+  std::mt19937 rng{1};
+  std::uniform_real_distribution<float> u{0, 10};
+
+  for (auto& p : points)
+    p.set(u(rng), u(rng), u(rng));
+  printf("KNN norm benchmark: %d points, %d queries\n",
+    n,
+    (n + queryStride - 1) / queryStride);
+
+  PointOctree<float, Points> tree{points};
+  PointGrid3<float, Points> grid{points, 0.25f};
+  LinearPointOctree<float, Points> linearTree{points};
+
+  for (auto k : ks)
+  {
+    bench("PointOctree", tree, points, k);
+    bench("PointGrid3", grid, points, k);
+    bench("LinearTree", linearTree, points, k);
+  }
+  return 0;
+}
@@ -0,0 +1,182 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2026 Paulo Pagliosa.                              |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: AlignedAllocator.h
+// ========
+// Class definition for aligned array allocator.
+//
+// Author: Paulo Pagliosa
+// Last revision: 19/10/2026
+
+#ifndef __AlignedAllocator_h
+#define __AlignedAllocator_h
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#ifdef __linux__
+#include <sys/mman.h>
+#endif // __linux__
+
+namespace cg
+{ // begin namespace cg
+
+constexpr size_t cacheLineSize = 64;
+constexpr size_t hugePageSize = 2 * 1024 * 1024;
+
+template <typename Allocator, typename = void>
+struct AllocatorAlignment
+{
+  // Arrays of an allocator that does not declare an alignment are
+  // only guaranteed to be aligned to alignof(T)
+  static constexpr size_t value = 0;
+
+}; // AllocatorAlignment
+
+template <typename Allocator>
+struct AllocatorAlignment<Allocator,
+  std::void_t<decltype(Allocator::alignment)>>
+{
+  static constexpr size_t value = Allocator::alignment;
+
+}; // AllocatorAlignment
+
+/**
+ * \brief Alignment (in bytes) guaranteed for the arrays allocated
+ * by \p Allocator, or 0 if unknown.
+ */
+template <typename Allocator>
+inline constexpr size_t allocatorAlignment =
+  AllocatorAlignment<Allocator>::value;
+
+/**
+ * \brief Tells the compiler that \p ptr is aligned to \p A bytes,
+ * so that aligned SIMD loads and stores can be used.
+ */
+template <size_t A, typename T>
+inline T*
+assumeAligned(T* ptr)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<T*>(__builtin_assume_aligned(ptr, A));
+#else
+  return ptr;
+#endif
+}
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// AlignedArrayAllocator: aligned array allocator class
+// =====================
+//
+// Allocator for Array/ArrayBase, SoA and ParticleSystem whose arrays
+// start at a multiple of A bytes (a power of two). Arrays of at least
+// hugePageThreshold bytes (if not 0) are aligned to 2 MB and, where
+// supported (Linux), advised to be backed by transparent huge pages.
+//
+template <size_t A, size_t hugePageThreshold = 0>
+class AlignedArrayAllocator
+{
+public:
+  static_assert(A != 0 && (A & (A - 1)) == 0,
+    "Alignment must be a power of two");
+
+  static constexpr size_t alignment = A;
+
+  template <typename T>
+  static T* allocate(size_t count)
+  {
+    auto size = count * sizeof(T);
+    auto a = std::max({A, alignof(T), alignof(Header)});
+    auto huge = hugePageThreshold != 0 && size >= hugePageThreshold;
+
+    if (huge)
+      a = std::max(a, hugePageSize);
+
+    // The header, which stores the address of the memory block and
+    // the number of elements, precedes the (aligned) array
+    auto block = (char*)::operator new(size + a + sizeof(Header));
+    auto data = uintptr_t(block) + sizeof(Header) + a - 1;
+
+    data &= ~uintptr_t(a - 1);
+    new ((char*)data - sizeof(Header)) Header{block, count};
+#ifdef __linux__
+    if (huge)
+      madvise((void*)data, size & ~(hugePageSize - 1), MADV_HUGEPAGE);
+#endif // __linux__
+
+    auto ptr = reinterpret_cast<T*>(data);
+
+    try
+    {
+      std::uninitialized_default_construct_n(ptr, count);
+    }
+    catch (...)
+    {
+      ::operator delete(block);
+      throw;
+    }
+    return ptr;
+  }
+
+  template <typename T>
+  static void free(T* ptr)
+  {
+    if (ptr == nullptr)
+      return;
+
+    auto h = (Header*)((char*)ptr - sizeof(Header));
+
+    std::destroy_n(ptr, h->count);
+    ::operator delete(h->block);
+  }
+
+private:
+  struct Header
+  {
+    void* block;
+    size_t count;
+
+  }; // Header
+
+}; // AlignedArrayAllocator
+
+// Array allocator for SIMD (up to AVX) loads and stores.
+using SIMDArrayAllocator = AlignedArrayAllocator<32>;
+
+// Array allocator for per-thread arrays free of false sharing.
+using CacheLineArrayAllocator = AlignedArrayAllocator<cacheLineSize>;
+
+// Array allocator for very large arrays (64 MB or more).
+using HugePageArrayAllocator =
+  AlignedArrayAllocator<cacheLineSize, 64 * 1024 * 1024>;
+
+} // end namespace cg
+
+#endif // __AlignedAllocator_h
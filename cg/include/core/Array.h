@@ -28,11 +28,12 @@
 // Class for generic array.
 //
 // Author: Paulo Pagliosa
-// Last revision: 10/02/2022
+// Last revision: 19/10/2026
 
 #ifndef __Array_h
 #define __Array_h
 
+#include "core/AlignedAllocator.h"
 #include <stdexcept>
 
 namespace cg
@@ -139,6 +140,9 @@ class ArrayBase
 public:
   using base_type = ArrayBase<T, Allocator>;
 
+  /// Alignment guaranteed for the data (0 if only alignof(T)).
+  static constexpr auto alignment = allocatorAlignment<Allocator>;
+
   ~ArrayBase()
   {
     Allocator::template free<T>(_data);
@@ -28,13 +28,17 @@
 // Class definition for block allocator.
 //
 // Author: Paulo Pagliosa
-// Last revision: 16/02/2019
+// Last revision: 19/10/2026
 
 #ifndef __BlockAllocator_h
 #define __BlockAllocator_h
 
+#include "core/MemoryAccounting.h"
+#include <algorithm>
+#include <cstdint>
 #include <mutex>
 #include <string>
+#include <vector>
 
 namespace cg
 { // begin namespace cg
@@ -48,6 +52,18 @@ roundupVoidPtr(size_t size)
   return (size + sizeof(void*) - 1) & -signed(sizeof(void*));
 }
 
+// Returns the index of the lowest set bit of m != 0.
+inline unsigned
+lowestBit(uint32_t m)
+{
+  static const unsigned char index[32] =
+  {
+    0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8,
+    31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9
+  };
+  return index[((m & -m) * 0x077cb531u) >> 27];
+}
+
 } // end namespace internal
 
 
@@ -55,6 +71,13 @@ roundupVoidPtr(size_t size)
 //
 // BlockStorage: block storage class
 // ============
+//
+// Each block keeps its own free list, the number of its allocated
+// chunks and a bitmap of them. Chunks are allocated from the current
+// block; when it is full, a block with free chunks (if any) becomes
+// the current one. Blocks whose chunks are all free can be released
+// by trim().
+//
 class BlockStorage
 {
 public:
@@ -65,12 +88,16 @@ public:
   /**
    * \brief Constructs a block storage whose blocks can
    * store \p maxSize chunks of size \p requestedSize.
+   * The memory of the blocks is accounted in \p category.
    */
-  BlockStorage(size_t requestedSize, unsigned maxSize):
+  BlockStorage(size_t requestedSize,
+    unsigned maxSize,
+    MemoryCategory category = MemoryCategory::Other):
     _chunkSize{internal::roundupVoidPtr(requestedSize)},
-    _maxSize{maxSize}
+    _maxSize{maxSize},
+    _category{category}
   {
-    _nextChunk = _blockSize = _chunkSize * maxSize;
+    _blockSize = _chunkSize * maxSize;
   }
 
   ~BlockStorage();
@@ -84,15 +111,39 @@ public:
    * \brief Deallocates the chunk of memory pointed by
    * \p ptr.
    */
-  void free(void* ptr)
+  void free(void* ptr);
+
+  /**
+   * \brief Allocates up to \p n chunks of memory and pushes
+   * them onto the list (linked through the chunks) whose head
+   * is \p list.
+   *
+   * \returns The number of chunks allocated.
+   */
+  unsigned allocate(void*& list, unsigned n);
+
+  /**
+   * \brief Deallocates the list of chunks from \p head to
+   * \p tail (linked through the chunks).
+   */
+  void free(void* head, void* tail);
+
+  /**
+   * \brief Releases the blocks whose chunks are all free.
+   *
+   * \returns The number of blocks released.
+   */
+  int trim();
+
+  int blockCount() const
   {
-    nextOf(ptr) = _freeList;
-    _freeList = ptr;
+    return (int)_blocks.size();
   }
 
-  int blockCount() const
+  /// Returns the number of allocated chunks.
+  auto chunkCount() const
   {
-    return _blockCount;
+    return _chunkCount;
   }
 
 protected:
@@ -100,17 +151,18 @@ protected:
 
   size_t _chunkSize;
   unsigned _maxSize;
+  MemoryCategory _category;
   size_t _blockSize;
-  int _blockCount{};
-  void* _freeList{};
-  Block* _headBlock{};
-  Block* _lastBlock{};
-  size_t _nextChunk;
+  size_t _chunkCount{};
+  std::vector<Block*> _blocks; // sorted by address
+  std::vector<Block*> _partialBlocks; // not current, with free chunks
+  Block* _currentBlock{};
 
-  void sortFreeList()
-  {
-    sort(_freeList);
-  }
+  /**
+   * \brief Calls \p f for every allocated chunk, in O(blocks)
+   * bitmap words.
+   */
+  template <typename F> void iterateChunks(F f) const;
 
   static void*& nextOf(void* ptr)
   {
@@ -119,9 +171,17 @@ protected:
 
 private:
   Block* allocateBlock();
+  Block* findBlock(void*) const;
+  void free(Block*, void*);
+  bool contains(const Block*, void*) const;
+  unsigned chunkIndex(const Block*, void*) const;
 
-  static void sort(void*&);
-  static void* merge(void*, void*);
+  auto bitmapSize() const
+  {
+    return (_maxSize + 31) / 32;
+  }
+
+  size_t blockMemorySize() const;
 
 }; // BlockStorage
 
@@ -142,73 +202,240 @@ struct BlockStorage::Block
     ::operator delete(ptr);
   }
 
-  Block* _next;
+  void* freeList{}; // free chunks of the block
+  unsigned used{}; // number of allocated chunks
+  unsigned next{}; // index of the first never allocated chunk
 
-  Block(Block* next = nullptr):
-    _next{next}
+  auto chunks() const
   {
-    // do nothing
+    return (char*)(this + 1);
   }
 
-  static void insert(Block*&, Block*);
+  // The bitmap of allocated chunks follows the chunks.
+  auto bitmap(size_t blockSize) const
+  {
+    return (uint32_t*)(chunks() + blockSize);
+  }
 
 }; // BlockStorage::Block
 
+template <typename F>
+void
+BlockStorage::iterateChunks(F f) const
+{
+  for (auto b : _blocks)
+  {
+    auto bits = b->bitmap(_blockSize);
+
+    for (unsigned w = 0, n = bitmapSize(); w < n; ++w)
+      for (auto m = bits[w]; m != 0; m &= m - 1)
+        f(b->chunks() + (w * 32 + internal::lowestBit(m)) * _chunkSize);
+  }
+}
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// BlockCacheStats: block cache statistics
+// ===============
+struct BlockCacheStats
+{
+  uint64_t hits; // allocations and frees served by a thread cache
+  uint64_t refills; // cache refills from the shared storage
+  uint64_t flushes; // cache flushes to the shared storage
+  uint64_t contentions; // times the shared storage was found locked
+
+}; // BlockCacheStats
+
 
 /////////////////////////////////////////////////////////////////////
 //
 // SingleBlockStorage: single block storage class
 // ==================
+//
+// Each thread keeps a cache (magazine) of up to 2 * magazineSize free
+// chunks. Allocations and frees are served by the cache of the calling
+// thread; the shared storage, protected by a mutex, is only accessed
+// to move magazineSize chunks at once when the cache is empty or full.
+// Since all chunks of the storage are interchangeable, a chunk freed
+// by a thread other than the one that allocated it just goes to the
+// cache of the former. The cache of a thread is flushed when it ends.
+//
 template <typename T, unsigned size>
 class SingletonBlockStorage
 {
 public:
+  static constexpr unsigned magazineSize{std::clamp(size / 4, 1u, 32u)};
+
   static T* allocate()
   {
-    storage_type& s = storage();
+    auto& c = cache();
 
-    s.lock();
+    if (c.count == 0 && c.refill() == 0)
+      return nullptr;
+    ++c.stats.hits;
+    --c.count;
 
-    auto ptr = static_cast<T*>(s.allocate());
+    auto ptr = c.head;
 
-    s.unlock();
-    return ptr;
+    c.head = storage_type::nextOf(ptr);
+    return static_cast<T*>(ptr);
   }
 
   static void free(T* ptr)
   {
-    storage_type& s = storage();
+    if (ptr == nullptr)
+      return;
+
+    auto& c = cache();
 
-    s.lock();
-    s.free(ptr);
-    s.unlock();
+    if (c.count == 2 * magazineSize)
+      c.flush(magazineSize);
+    ++c.stats.hits;
+    ++c.count;
+    storage_type::nextOf(ptr) = c.head;
+    c.head = ptr;
   }
 
   static int blockCount()
   {
     storage_type& s = storage();
+    std::lock_guard<std::mutex> lock{s};
 
-    s.lock();
+    return s.blockCount();
+  }
 
-    auto count = s.blockCount();
+  /**
+   * \brief Returns the cache statistics of the storage.
+   *
+   * The counters of a thread are added to the statistics every
+   * time its cache is refilled or flushed, and when it ends.
+   */
+  static BlockCacheStats cacheStats()
+  {
+    storage_type& s = storage();
+    std::lock_guard<std::mutex> lock{s};
+
+    return s.stats;
+  }
+
+  /**
+   * \brief Returns all the chunks cached by the calling thread
+   * to the shared storage.
+   */
+  static void flushCache()
+  {
+    auto& c = cache();
+
+    c.flush(c.count);
+  }
+
+  /**
+   * \brief Flushes the cache of the calling thread and releases
+   * the blocks whose chunks are all free. Chunks cached by other
+   * threads keep their blocks alive.
+   *
+   * \returns The number of blocks released.
+   */
+  static int trim()
+  {
+    flushCache();
 
-    s.unlock();
-    return count;
+    storage_type& s = storage();
+    std::lock_guard<std::mutex> lock{s};
+
+    return s.trim();
   }
 
 private:
   struct storage_type: public std::mutex, BlockStorage
   {
+    BlockCacheStats stats{};
+
     storage_type():
-      BlockStorage{sizeof(T), size}
+      BlockStorage{sizeof(T), size, memoryCategoryOf<T>}
     {
 #ifdef _DEBUG
       typeName = typeid(T).name();
 #endif
     }
 
+    using BlockStorage::nextOf;
+
   }; // storage_type
 
+  struct cache_type
+  {
+    void* head{};
+    unsigned count{};
+    BlockCacheStats stats{};
+
+    ~cache_type()
+    {
+      flush(count);
+    }
+
+    unsigned refill()
+    {
+      storage_type& s = lock();
+
+      count = s.allocate(head, magazineSize);
+      ++stats.refills;
+      publish(s);
+      s.unlock();
+      return count;
+    }
+
+    void flush(unsigned n)
+    {
+      if (n == 0)
+        return;
+
+      auto tail = head;
+
+      for (auto i = n; --i;)
+        tail = storage_type::nextOf(tail);
+
+      auto rest = storage_type::nextOf(tail);
+      storage_type& s = lock();
+
+      s.free(head, tail);
+      ++stats.flushes;
+      publish(s);
+      s.unlock();
+      head = rest;
+      count -= n;
+    }
+
+    storage_type& lock()
+    {
+      storage_type& s = storage();
+
+      if (!s.try_lock())
+      {
+        ++stats.contentions;
+        s.lock();
+      }
+      return s;
+    }
+
+    void publish(storage_type& s)
+    {
+      s.stats.hits += stats.hits;
+      s.stats.refills += stats.refills;
+      s.stats.flushes += stats.flushes;
+      s.stats.contentions += stats.contentions;
+      stats = {};
+    }
+
+  }; // cache_type
+
+  static cache_type& cache()
+  {
+    thread_local cache_type c;
+    return c;
+  }
+
   static storage_type& storage()
   {
     static storage_type* s;
@@ -0,0 +1,207 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2026 Paulo Pagliosa.                              |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: MemoryAccounting.h
+// ========
+// Class definition for memory accounting registry.
+//
+// Author: Paulo Pagliosa
+// Last revision: 19/10/2026
+
+#ifndef __MemoryAccounting_h
+#define __MemoryAccounting_h
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace cg
+{ // begin namespace cg
+
+enum class MemoryCategory
+{
+  Meshes,
+  BVH,
+  TreeNodes,
+  IndexLists,
+  Images,
+  VisDatasets,
+  Other
+
+}; // MemoryCategory
+
+constexpr auto memoryCategoryCount = size_t(MemoryCategory::Other) + 1;
+
+/**
+ * \brief Memory category of the objects of type T allocated by a
+ * SingletonBlockStorage. Specialized next to the types.
+ */
+template <typename T>
+inline constexpr auto memoryCategoryOf = MemoryCategory::Other;
+
+struct MemoryCounters
+{
+  size_t liveBytes;
+  size_t peakBytes;
+  uint64_t allocations;
+  uint64_t frees;
+
+}; // MemoryCounters
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// MemoryAccounting: memory accounting registry class
+// ================
+//
+// Counts the bytes allocated and freed by category. Updates are
+// relaxed atomic additions on a cache line per category, so that the
+// accounting can stay on in release builds; it can be compiled out by
+// defining _NO_MEMORY_ACCOUNTING. Allocators report memory at their
+// own granularity (e.g., BlockStorage reports whole blocks).
+//
+class MemoryAccounting
+{
+public:
+  MemoryAccounting() = delete;
+
+  static void allocate(MemoryCategory c, size_t bytes) noexcept
+  {
+#ifndef _NO_MEMORY_ACCOUNTING
+    auto& s = _slots[size_t(c)];
+    auto live = s.liveBytes.fetch_add(bytes, relaxed) + bytes;
+    auto peak = s.peakBytes.load(relaxed);
+
+    s.allocations.fetch_add(1, relaxed);
+    while (live > peak
+      && !s.peakBytes.compare_exchange_weak(peak, live, relaxed))
+      ;
+#endif // _NO_MEMORY_ACCOUNTING
+  }
+
+  static void free(MemoryCategory c, size_t bytes) noexcept
+  {
+#ifndef _NO_MEMORY_ACCOUNTING
+    auto& s = _slots[size_t(c)];
+
+    s.liveBytes.fetch_sub(bytes, relaxed);
+    s.frees.fetch_add(1, relaxed);
+#endif // _NO_MEMORY_ACCOUNTING
+  }
+
+  /// Returns the counters of the category \p c.
+  static MemoryCounters counters(MemoryCategory c);
+
+  /// Returns the counters summed over all categories.
+  static MemoryCounters total();
+
+  /// Makes the peak of every category equal to its live bytes.
+  static void resetPeaks();
+
+  /// Returns the name of the category \p c.
+  static const char* name(MemoryCategory c);
+
+  /// Returns the counters of all categories as a JSON object.
+  static std::string toJSON();
+
+private:
+  static constexpr auto relaxed = std::memory_order_relaxed;
+
+  struct alignas(64) Slot
+  {
+    std::atomic<size_t> liveBytes;
+    std::atomic<size_t> peakBytes;
+    std::atomic<uint64_t> allocations;
+    std::atomic<uint64_t> frees;
+
+  }; // Slot
+
+  static inline Slot _slots[memoryCategoryCount];
+
+}; // MemoryAccounting
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// AccountingAllocator: accounting allocator class for std containers
+// ===================
+//
+// Reports the memory allocated and freed by a container under the
+// category C.
+//
+template <typename T, MemoryCategory C>
+class AccountingAllocator
+{
+public:
+  using value_type = T;
+
+  template <typename U>
+  struct rebind
+  {
+    using other = AccountingAllocator<U, C>;
+
+  }; // rebind
+
+  AccountingAllocator() = default;
+
+  template <typename U>
+  AccountingAllocator(const AccountingAllocator<U, C>&) noexcept
+  {
+    // do nothing
+  }
+
+  T* allocate(size_t n)
+  {
+    auto ptr = std::allocator<T>{}.allocate(n);
+
+    MemoryAccounting::allocate(C, n * sizeof(T));
+    return ptr;
+  }
+
+  void deallocate(T* ptr, size_t n) noexcept
+  {
+    MemoryAccounting::free(C, n * sizeof(T));
+    std::allocator<T>{}.deallocate(ptr, n);
+  }
+
+  template <typename U>
+  bool operator ==(const AccountingAllocator<U, C>&) const
+  {
+    return true;
+  }
+
+  template <typename U>
+  bool operator !=(const AccountingAllocator<U, C>&) const
+  {
+    return false;
+  }
+
+}; // AccountingAllocator
+
+} // end namespace cg
+
+#endif // __MemoryAccounting_h
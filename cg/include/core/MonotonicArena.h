@@ -0,0 +1,346 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2026 Paulo Pagliosa.                              |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: MonotonicArena.h
+// ========
+// Class definition for monotonic arena allocator.
+//
+// Author: Paulo Pagliosa
+// Last revision: 19/10/2026
+
+#ifndef __MonotonicArena_h
+#define __MonotonicArena_h
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace cg
+{ // begin namespace cg
+
+//
+// Deleter of an object constructed in an arena: destroys the object,
+// whose memory is freed when the arena is rewound
+//
+struct ArenaDelete
+{
+  template <typename T>
+  void operator ()(T* ptr) const
+  {
+    std::destroy_at(ptr);
+  }
+
+}; // ArenaDelete
+
+template <typename T> using ArenaPtr = std::unique_ptr<T, ArenaDelete>;
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// MonotonicArena: monotonic arena allocator class
+// ==============
+//
+// An arena hands out memory from chunks of (at least) chunkSize bytes
+// by bumping a pointer. Memory is never freed individually (except the
+// last allocation, see free()), but in bulk, by rewinding the arena to
+// a previous mark. Chunks are kept for reuse after a rewind, except the
+// oversized ones (made for allocations larger than chunkSize).
+//
+class MonotonicArena
+{
+public:
+  static constexpr size_t defaultChunkSize = 64 * 1024;
+
+  struct Marker
+  {
+    void* chunk;
+    char* top;
+
+  }; // Marker
+
+  /// Constructs an empty arena.
+  MonotonicArena(size_t chunkSize = defaultChunkSize):
+    _chunkSize{chunkSize}
+  {
+    // do nothing
+  }
+
+  MonotonicArena(const MonotonicArena&) = delete;
+  MonotonicArena& operator =(const MonotonicArena&) = delete;
+
+  /// Destructor. Frees all chunks.
+  ~MonotonicArena()
+  {
+    release();
+  }
+
+  /**
+   * \brief Allocates \p size bytes aligned to \p alignment (a
+   * power of two).
+   */
+  void* allocate(size_t size, size_t alignment = alignof(std::max_align_t))
+  {
+    auto p = (uintptr_t(_top) + alignment - 1) & ~uintptr_t(alignment - 1);
+
+    if (_top == nullptr || p + size > uintptr_t(_end))
+      return allocateChunk(size, alignment);
+    _top = (char*)p + size;
+    return (void*)p;
+  }
+
+  /// Allocates uninitialized memory for \p count objects of type T.
+  template <typename T>
+  T* allocate(size_t count)
+  {
+    return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+  }
+
+  /**
+   * \brief Constructs an object of type T in this arena. The object
+   * must be destroyed before the arena is rewound.
+   */
+  template <typename T, typename... Args>
+  ArenaPtr<T> make(Args&&... args)
+  {
+    return ArenaPtr<T>{new (allocate<T>(1)) T(std::forward<Args>(args)...)};
+  }
+
+  /**
+   * \brief Frees the memory of \p size bytes pointed by \p ptr if
+   * it is the last allocation; otherwise, does nothing.
+   */
+  void free(void* ptr, size_t size)
+  {
+    if ((char*)ptr + size == _top)
+      _top = (char*)ptr;
+  }
+
+  /**
+   * \brief Makes sure the next \p size bytes, aligned to at most
+   * alignof(std::max_align_t), can be allocated without a new chunk.
+   * If needed, allocates a chunk of exactly \p size bytes, so an arena
+   * whose total size is known beforehand does not waste a whole chunk.
+   */
+  void reserve(size_t size);
+
+  /// Returns a mark of the current state of this arena.
+  Marker mark() const
+  {
+    return {_chunk, _top};
+  }
+
+  /// Frees the memory allocated after the mark \p m was made.
+  void rewind(const Marker& m);
+
+  /// Frees the memory allocated by this arena, keeping its chunks.
+  void reset()
+  {
+    rewind({});
+  }
+
+  /// Frees the memory allocated by this arena and its chunks.
+  void release();
+
+  /// Returns the number of chunks of this arena.
+  auto chunkCount() const
+  {
+    return _chunkCount;
+  }
+
+  /// Returns the total size of the chunks of this arena.
+  auto capacity() const
+  {
+    return _capacity;
+  }
+
+  /// Returns the number of chunks allocated by this arena so far.
+  auto mallocCount() const
+  {
+    return _mallocCount;
+  }
+
+  /**
+   * \brief Returns the arena of the calling thread for temporary
+   * allocations. Use it with an ArenaScope.
+   */
+  static MonotonicArena& frame();
+
+private:
+  struct Chunk;
+
+  size_t _chunkSize;
+  Chunk* _head{};
+  Chunk* _chunk{};
+  char* _top{};
+  char* _end{};
+  size_t _chunkCount{};
+  size_t _capacity{};
+  size_t _mallocCount{};
+
+  Chunk* insertChunk(size_t);
+  void* allocateChunk(size_t, size_t);
+  void freeChunk(Chunk*);
+
+}; // MonotonicArena
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// ArenaScope: arena scope class
+// ==========
+//
+// Rewinds an arena, on destruction, to its state on construction.
+//
+class ArenaScope
+{
+public:
+  ArenaScope(MonotonicArena& arena = MonotonicArena::frame()):
+    _arena{arena},
+    _marker{arena.mark()}
+  {
+    // do nothing
+  }
+
+  ArenaScope(const ArenaScope&) = delete;
+  ArenaScope& operator =(const ArenaScope&) = delete;
+
+  ~ArenaScope()
+  {
+    _arena.rewind(_marker);
+  }
+
+  auto& arena() const
+  {
+    return _arena;
+  }
+
+private:
+  MonotonicArena& _arena;
+  MonotonicArena::Marker _marker;
+
+}; // ArenaScope
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// ArenaAllocator: arena allocator class for std containers
+// ==============
+template <typename T>
+class ArenaAllocator
+{
+public:
+  using value_type = T;
+
+  /// Constructs an allocator for the arena of the calling thread.
+  ArenaAllocator():
+    _arena{&MonotonicArena::frame()}
+  {
+    // do nothing
+  }
+
+  ArenaAllocator(MonotonicArena& arena):
+    _arena{&arena}
+  {
+    // do nothing
+  }
+
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>& other):
+    _arena{&other.arena()}
+  {
+    // do nothing
+  }
+
+  T* allocate(size_t n)
+  {
+    return _arena->template allocate<T>(n);
+  }
+
+  void deallocate(T* ptr, size_t n)
+  {
+    _arena->free(ptr, n * sizeof(T));
+  }
+
+  auto& arena() const
+  {
+    return *_arena;
+  }
+
+  template <typename U>
+  bool operator ==(const ArenaAllocator<U>& other) const
+  {
+    return _arena == &other.arena();
+  }
+
+  template <typename U>
+  bool operator !=(const ArenaAllocator<U>& other) const
+  {
+    return _arena != &other.arena();
+  }
+
+private:
+  MonotonicArena* _arena;
+
+}; // ArenaAllocator
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// ArenaArrayAllocator: arena array allocator class
+// ===================
+//
+// Allocator for Array/ArrayBase that takes the memory from the arena
+// of the calling thread. The arrays must be destroyed before the scope
+// in which they were created ends.
+//
+class ArenaArrayAllocator
+{
+public:
+  template <typename T>
+  static T* allocate(size_t count)
+  {
+    static_assert(std::is_trivially_destructible_v<T>,
+      "Trivially destructible type expected");
+
+    auto ptr = MonotonicArena::frame().allocate<T>(count);
+
+    std::uninitialized_default_construct_n(ptr, count);
+    return ptr;
+  }
+
+  template <typename T>
+  static void free(T*)
+  {
+    // do nothing
+  }
+
+}; // ArenaArrayAllocator
+
+} // end namespace cg
+
+#endif // __MonotonicArena_h
@@ -28,7 +28,7 @@
 // Class definition for object pool.
 //
 // Author: Paulo Pagliosa
-// Last revision: 01/09/2018
+// Last revision: 19/10/2026
 
 #ifndef __ObjectPool_h
 #define __ObjectPool_h
@@ -69,10 +69,11 @@ public:
 
   /**
    * \brief Constructs an object pool for objects of
-   * type T.
+   * type T, whose memory is accounted in \p category.
    */
-  ObjectPool(unsigned size = defaultSize):
-    BlockStorage{sizeof(T), size}
+  ObjectPool(unsigned size = defaultSize,
+    MemoryCategory category = memoryCategoryOf<T>):
+    BlockStorage{sizeof(T), size, category}
   {
     // do nothing
   }
@@ -142,6 +143,20 @@ public:
     free(ptr);
   }
 
+  /**
+   * \brief Releases the blocks of the pool that store no
+   * objects.
+   *
+   * \returns The number of blocks released.
+   */
+  int trim()
+  {
+    std::lock_guard<std::mutex> lock{*this};
+    return BlockStorage::trim();
+  }
+
+  using BlockStorage::blockCount;
+
   Stats stats() const
   {
     return _stats;
@@ -155,27 +170,8 @@ private:
 template <typename T>
 ObjectPool<T>::~ObjectPool()
 {
-  if (_freeList == nullptr)
-    return;
-  sortFreeList();
-  for (auto b = _headBlock; b != nullptr; b = b->_next)
-  {
-    auto s = b == _lastBlock ? _nextChunk : _blockSize;
-    auto i = (char*)(b + 1);
-    auto e = (char*)(b + 1) + s;
-
-    for (; i != e; i += _chunkSize)
-    {
-      if ((void*)i == _freeList)
-      {
-        _freeList = nextOf(_freeList);
-        continue;
-      }
-      // Chunk pointed by i is allocated.
-      // Destroy the object stored in the chunk.
-      static_cast<T*>((void*)i)->~T();
-    }
-  }
+  // Destroy the objects stored in the allocated chunks
+  iterateChunks([](void* ptr) { static_cast<T*>(ptr)->~T(); });
 }
 
 } // end namespace cg
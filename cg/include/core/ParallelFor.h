@@ -0,0 +1,93 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2026 Paulo Pagliosa.                              |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: ParallelFor.h
+// ========
+// Parallel loop helpers.
+//
+// Author: Paulo Pagliosa
+// Last revision: 19/10/2026
+
+#ifndef __ParallelFor_h
+#define __ParallelFor_h
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace cg
+{ // begin namespace cg
+
+/**
+ * \brief Returns the number of threads used by parallelFor() to
+ * process \p n items with at most \p threadCount threads (0 for the
+ * number of hardware threads).
+ */
+inline int
+parallelThreads(size_t n, int threadCount = 0)
+{
+  if (threadCount <= 0)
+    threadCount = std::max(int(std::thread::hardware_concurrency()), 1);
+  return int(std::max(std::min(size_t(threadCount), n), size_t(1)));
+}
+
+/**
+ * \brief Splits [0, \p n) into parallelThreads(n, threadCount)
+ * contiguous ranges and calls f(begin, end, t) for the t-th range.
+ * The ranges depend only on \p n and the number of threads, so two
+ * calls with the same arguments process the same items in each t.
+ */
+template <typename F>
+void
+parallelFor(size_t n, F&& f, int threadCount = 0)
+{
+  auto t = parallelThreads(n, threadCount);
+
+  if (t == 1)
+  {
+    f(size_t(0), n, 0);
+    return;
+  }
+
+  auto range = [n, t](int i)
+  {
+    return n * i / t;
+  };
+  std::vector<std::thread> threads;
+
+  threads.reserve(t - 1);
+  for (int i = 1; i < t; ++i)
+    threads.emplace_back([&f, &range, i]()
+    {
+      f(range(i), range(i + 1), i);
+    });
+  f(size_t(0), range(1), 0);
+  for (auto& thread : threads)
+    thread.join();
+}
+
+} // end namespace cg
+
+#endif // __ParallelFor_h
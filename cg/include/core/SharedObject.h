@@ -28,12 +28,14 @@
 // Class definition for shared object.
 //
 // Author: Paulo Pagliosa
-// Last revision: 19/01/2022
+// Last revision: 19/10/2026
 
 #ifndef __SharedObject_h
 #define __SharedObject_h
 
+#include <atomic>
 #include <type_traits>
+#include <utility>
 
 namespace cg
 { // begin namespace cg
@@ -57,6 +59,14 @@ isSharedObject()
 //
 // SharedObject: shared object class
 // ============
+//
+// The reference count of a shared object is updated with plain loads
+// and stores, unless the object uses an atomic reference count. This
+// is the case for all objects when the library is compiled with
+// _ATOMIC_REFERENCE_COUNT defined, or for the objects of the types
+// that call useAtomicReferenceCount() in their constructors (which
+// should be done before the object is referenced by anyone).
+//
 class SharedObject
 {
 public:
@@ -66,7 +76,13 @@ public:
   /// Returns the number of references of this object.
   auto referenceCount() const
   {
-    return _referenceCount;
+    return _referenceCount.load(std::memory_order_relaxed);
+  }
+
+  /// Returns true if the reference count of this object is atomic.
+  auto hasAtomicReferenceCount() const
+  {
+    return _atomicReferenceCount;
   }
 
   template <typename T>
@@ -74,7 +90,7 @@ public:
   {
     ASSERT_SHARED(T, "Pointer to shared object expected");
     if (ptr != nullptr)
-      ++ptr->_referenceCount;
+      ptr->incReferenceCount();
     return (T*)ptr;
   }
 
@@ -82,17 +98,70 @@ public:
   static void release(T* ptr)
   {
     ASSERT_SHARED(T, "Pointer to shared object expected");
-    if (ptr != nullptr && --ptr->_referenceCount <= 0)
+    if (ptr != nullptr && ptr->decReferenceCount() <= 0)
       delete ptr;
   }
 
+  /// Keeps the reference count of this object.
+  SharedObject& operator =(const SharedObject&)
+  {
+    return *this;
+  }
+
 protected:
   /// Constructs an unreferenced object.
   SharedObject() = default;
 
+  /// Constructs an unreferenced copy of other.
+  SharedObject(const SharedObject& other):
+    _atomicReferenceCount{other._atomicReferenceCount}
+  {
+    // do nothing
+  }
+
+  /// Makes the reference count of this object atomic.
+  void useAtomicReferenceCount()
+  {
+    _atomicReferenceCount = true;
+  }
+
 private:
-  mutable int _referenceCount{};
-  
+#ifdef _ATOMIC_REFERENCE_COUNT
+  static constexpr bool defaultAtomicReferenceCount{true};
+#else
+  static constexpr bool defaultAtomicReferenceCount{false};
+#endif // _ATOMIC_REFERENCE_COUNT
+
+  mutable std::atomic<int> _referenceCount{};
+  bool _atomicReferenceCount{defaultAtomicReferenceCount};
+
+  void incReferenceCount() const
+  {
+    constexpr auto relaxed = std::memory_order_relaxed;
+
+    // A new reference is always made from an existing one (or from a
+    // newly created object), thus no ordering is needed here.
+    if (_atomicReferenceCount)
+      _referenceCount.fetch_add(1, relaxed);
+    else
+      _referenceCount.store(_referenceCount.load(relaxed) + 1, relaxed);
+  }
+
+  int decReferenceCount() const
+  {
+    constexpr auto relaxed = std::memory_order_relaxed;
+
+    // The last release must see all the writes made to the object by
+    // the threads that released it before, thus acquire-release.
+    if (_atomicReferenceCount)
+      return _referenceCount.fetch_sub(1, std::memory_order_acq_rel) - 1;
+
+    auto count = _referenceCount.load(relaxed) - 1;
+
+    _referenceCount.store(count, relaxed);
+    return count;
+  }
+
 }; // SharedObject
 
 
@@ -118,6 +187,13 @@ public:
     // do nothing
   }
 
+  /// Takes over the reference of other, leaving it null.
+  Reference(reference&& other) noexcept:
+    _ptr{std::exchange(other._ptr, nullptr)}
+  {
+    // do nothing
+  }
+
   Reference(const T* ptr):
     _ptr{SharedObject::makeUse(ptr)}
   {
@@ -134,10 +210,19 @@ public:
     return operator =(other._ptr);
   }
 
+  /// Takes over the reference of other, leaving it null.
+  reference& operator =(reference&& other) noexcept
+  {
+    if (this != &other)
+      SharedObject::release(std::exchange(_ptr,
+        std::exchange(other._ptr, nullptr)));
+    return *this;
+  }
+
   reference& operator =(const T* ptr)
   {
-    SharedObject::release(_ptr);
-    _ptr = SharedObject::makeUse(ptr);
+    // Use before release, since ptr can be owned by *_ptr
+    SharedObject::release(std::exchange(_ptr, SharedObject::makeUse(ptr)));
     return *this;
   }
 
@@ -186,6 +271,80 @@ private:
 
 }; // Reference
 
+
+/////////////////////////////////////////////////////////////////////
+//
+// Borrowed: borrowed shared object pointer class
+// ========
+//
+// A borrowed pointer does not touch the reference count of the object
+// it points to, so it can be freely copied in hot loops (and between
+// threads). It is valid as long as some reference keeps the object
+// alive; for this reason, it cannot be made from a temporary reference.
+//
+template <typename T>
+class Borrowed
+{
+public:
+  Borrowed(const T* ptr = nullptr):
+    _ptr{(T*)ptr}
+  {
+    ASSERT_SHARED(T, "Pointer to shared object expected");
+  }
+
+  Borrowed(const Reference<T>& ref):
+    _ptr{ref.get()}
+  {
+    // do nothing
+  }
+
+  Borrowed(Reference<T>&&) = delete;
+
+  bool operator ==(const T* ptr) const
+  {
+    return _ptr == ptr;
+  }
+
+  bool operator !=(const T* ptr) const
+  {
+    return _ptr != ptr;
+  }
+
+  operator T*() const
+  {
+    return _ptr;
+  }
+
+  auto operator->() const
+  {
+    return _ptr;
+  }
+
+  auto get() const
+  {
+    return _ptr;
+  }
+
+  auto& operator *() const
+  {
+    return *_ptr;
+  }
+
+private:
+  T* _ptr;
+
+}; // Borrowed
+
+/// Returns a borrowed pointer to the object referenced by ref.
+template <typename T>
+inline auto
+borrow(const Reference<T>& ref)
+{
+  return Borrowed<T>{ref};
+}
+
+template <typename T> void borrow(Reference<T>&&) = delete;
+
 } // end namespace cg
 
 #endif // __SharedObject_h
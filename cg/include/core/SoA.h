@@ -28,7 +28,7 @@
 // Class definition for structure of arrays.
 //
 // Author: Paulo Pagliosa
-// Last revision: 12/09/2022
+// Last revision: 19/10/2026
 
 #ifndef __SoA_h
 #define __SoA_h
@@ -430,6 +430,9 @@ public:
   using const_iterator = SoAConstIterator<index_t, Args...>;
   using iterator = SoAIterator<index_t, Args...>;
 
+  /// Alignment guaranteed for every array (0 if only alignof(T)).
+  static constexpr auto alignment = allocatorAlignment<Allocator>;
+
   ~SoA()
   {
     if (this->_size != 0)
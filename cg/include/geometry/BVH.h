@@ -28,11 +28,13 @@
 // Class definition for BVH.
 //
 // Author: Paulo Pagliosa
-// Last revision: 10/02/2022
+// Last revision: 19/10/2026
 
 #ifndef __BVH_h
 #define __BVH_h
 
+#include "core/MemoryAccounting.h"
+#include "core/MonotonicArena.h"
 #include "core/SharedObject.h"
 #include "geometry/Bounds3.h"
 #include "geometry/Intersection.h"
@@ -55,6 +57,26 @@ struct BVHNodeInfo
 
 using BVHNodeFunction = std::function<void(const BVHNodeInfo&)>;
 
+struct BVHStats
+{
+  uint64_t nodeVisits;
+  uint64_t primitiveTests;
+  uint64_t triangleTests;
+
+}; // BVHStats
+
+/**
+ *  Returns the BVH traversal counters of the calling thread. The
+ *  counters are never reset; a client takes the difference of two
+ *  snapshots.
+ */
+inline BVHStats&
+bvhStats()
+{
+  thread_local BVHStats stats{};
+  return stats;
+}
+
 
 /////////////////////////////////////////////////////////////////////
 //
@@ -70,6 +92,12 @@ public:
     return (size_t)_nodeCount;
   }
 
+  /// Returns the size in bytes of the nodes and indices of this BVH.
+  auto memorySize() const
+  {
+    return _memorySize;
+  }
+
   Bounds3f bounds() const;
   bool intersect(const Ray3f&) const;
   bool intersect(const Ray3f&, Intersection&) const;
@@ -78,7 +106,9 @@ public:
 protected:
   struct PrimitiveInfo;
 
-  using PrimitiveInfoArray = std::vector<PrimitiveInfo>;
+  // Build temporaries live in the arena of the calling thread
+  using PrimitiveInfoArray =
+    std::vector<PrimitiveInfo, ArenaAllocator<PrimitiveInfo>>;
   using IndexArray = std::vector<uint32_t>;
 
   IndexArray _primitiveIds;
@@ -86,17 +116,11 @@ protected:
   BVHBase(uint32_t maxPrimitivesPerNode):
     _maxPrimitivesPerNode{maxPrimitivesPerNode}
   {
-    // do nothing
+    // BVHs can be shared by several rendering threads
+    useAtomicReferenceCount();
   }
 
-  void build(PrimitiveInfoArray& primitiveInfo)
-  {
-    auto np = (uint32_t)primitiveInfo.size();
-    IndexArray orderedPrimitiveIds(np);
-
-    _root = makeNode(primitiveInfo, 0, np, orderedPrimitiveIds);
-    _primitiveIds.swap(orderedPrimitiveIds);
-  }
+  void build(PrimitiveInfoArray& primitiveInfo);
 
   virtual bool intersectLeaf(uint32_t, uint32_t, const Ray3f&) const = 0;
   virtual void intersectLeaf(uint32_t,
@@ -110,7 +134,12 @@ private:
 
   Node* _root{};
   uint32_t _nodeCount{};
+  uint32_t _depth{};
   uint32_t _maxPrimitivesPerNode;
+  MonotonicArena _nodes;
+  size_t _memorySize{};
+
+  template <typename... Args> Node* newNode(Args&&...);
 
   Node* makeNode(PrimitiveInfoArray&, uint32_t, uint32_t, IndexArray&);
   Node* makeLeaf(PrimitiveInfoArray&, uint32_t, uint32_t, IndexArray&);
@@ -174,6 +203,7 @@ BVH<T>::BVH(PrimitiveArray&& primitives, uint32_t maxPrimitivesPerNode):
   assert(np > 0);
   _primitiveIds.resize(np);
 
+  ArenaScope scope;
   PrimitiveInfoArray primitiveInfo(np);
 
   for (uint32_t i = 0; i < np; ++i)
@@ -185,11 +215,13 @@ template <typename T>
 bool
 BVH<T>::intersectLeaf(uint32_t first, uint32_t count, const Ray3f& ray) const
 {
+  auto& stats = bvhStats();
+
   for (auto i = first, e = i + count; i < e; ++i)
   {
     const auto& p = _primitives[_primitiveIds[i]];
-    Intersection temp;
 
+    ++stats.primitiveTests;
     if (p->intersect(ray))
       return true;
   }
@@ -203,6 +235,7 @@ BVH<T>::intersectLeaf(uint32_t first,
   const Ray3f& ray,
   Intersection& hit) const
 {
+  bvhStats().primitiveTests += count;
   for (auto i = first, e = i + count; i < e; ++i)
   {
     const auto& p = _primitives[_primitiveIds[i]];
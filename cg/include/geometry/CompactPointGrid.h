@@ -0,0 +1,386 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2026 Paulo Pagliosa.                              |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: CompactPointGrid.h
+// ========
+// Class definition for compact point grid.
+//
+// Author: Paulo Pagliosa
+// Last revision: 19/10/2026
+
+#ifndef __CompactPointGrid_h
+#define __CompactPointGrid_h
+
+#include "core/ParallelFor.h"
+#include "geometry/Grid2.h"
+#include "geometry/Grid3.h"
+#include "geometry/IndexList.h"
+#include "geometry/NeighborTable.h"
+#include "geometry/PointHolder.h"
+#include <algorithm>
+#include <vector>
+
+namespace cg
+{ // begin namespace cg
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// CompactPointGrid: compact point grid class
+// ================
+//
+// Static point grid whose cells are stored in CSR form: the ids of
+// the points are kept in a single array sorted by cell id, and each
+// grid cell holds the offset of its first point in that array. The
+// grid is (re)built by a parallel counting sort. Optionally, the
+// point positions are reordered to match the sorted ids, so that the
+// points of a cell are contiguous in memory.
+//
+template <int D, typename real, typename PA, typename ID = int>
+class CompactPointGrid: public RegionGrid<D, real, ID>,
+  public PointHolder<D, real, PA>
+{
+public:
+  using type = CompactPointGrid<D, real, PA, ID>;
+  using Base = RegionGrid<D, real, ID>;
+  using PointSet = PointHolder<D, real, PA>;
+  using point_id = ID;
+  using pid_list = IndexList<point_id>;
+  using vec_type = Vector<real, D>;
+  using bounds_type = Bounds<real, D>;
+  using id_type = typename Base::id_type;
+  using index_type = typename Base::index_type;
+  using Neighbors = NeighborTable<point_id, real>;
+
+  /// Range of the points of a cell in ids() and positions().
+  struct Range
+  {
+    point_id begin;
+    point_id end;
+
+    auto size() const
+    {
+      return end - begin;
+    }
+
+  }; // Range
+
+  CompactPointGrid(const Bounds<real, D>& bounds,
+    const PA& points,
+    real h,
+    bool reorder = false,
+    int threadCount = 0);
+
+  CompactPointGrid(const PA& points,
+    real h,
+    bool squared = true,
+    bool reorder = false,
+    int threadCount = 0):
+    type{PointSet::computeBounds(points, squared),
+      points,
+      h,
+      reorder,
+      threadCount}
+  {
+    // do nothing
+  }
+
+  /// Rebuilds this grid from the current positions of the points.
+  void rebuild();
+
+  /// Returns the ids of the points in the grid, sorted by cell id.
+  const auto& ids() const
+  {
+    return _ids;
+  }
+
+  /// Returns the positions of the points in the order of ids().
+  /// The array is empty if the grid was built without reordering.
+  const auto& positions() const
+  {
+    return _positions;
+  }
+
+  bool isReordered() const
+  {
+    return _reorder;
+  }
+
+  auto pointCount() const
+  {
+    return _ids.size();
+  }
+
+  auto position(point_id j) const
+  {
+    return _reorder ? _positions[j] : vec_type{this->_points[_ids[j]]};
+  }
+
+  Range range(id_type id) const
+  {
+    auto end = id + 1 < this->length() ?
+      (*this)[id + 1] :
+      point_id(_ids.size());
+    return {(*this)[id], end};
+  }
+
+  Range range(const index_type& index) const
+  {
+    return range(this->id(index));
+  }
+
+  /// Calls f(id, d2) for each point whose squared distance d2 to
+  /// \p point is not greater than \p radius squared.
+  template <typename F>
+  void forEachNeighbor(const vec_type& point, real radius, F f) const;
+
+  /// Calls f(id) for each point inside \p box.
+  template <typename F>
+  void forEachPoint(const bounds_type& box, F f) const
+  {
+    this->forEachCell(box, [&](auto id, bool inside)
+    {
+      for (auto r = range(id); r.begin < r.end; ++r.begin)
+        if (inside || box.contains(position(r.begin)))
+          f(_ids[r.begin]);
+    });
+  }
+
+  /// Calls f(id) for each point inside \p volume.
+  template <typename F>
+  void forEachPoint(const ConvexVolume<real, D>& volume, F f) const
+  {
+    this->forEachCell(volume, [&](auto id, bool inside)
+    {
+      for (auto r = range(id); r.begin < r.end; ++r.begin)
+        if (inside || volume.contains(position(r.begin)))
+          f(_ids[r.begin]);
+    });
+  }
+
+  /// Finds the points within \p radius of each of the \p n query
+  /// points in parallel (see NeighborTable).
+  void findNeighbors(const vec_type* points,
+    size_t n,
+    real radius,
+    Neighbors& neighbors,
+    bool withDistances = false,
+    int threadCount = 0) const
+  {
+    neighbors.build(n, [&](size_t i, auto f)
+    {
+      forEachNeighbor(points[i], radius, f);
+    }, withDistances, threadCount);
+  }
+
+  size_t findNeighbors(const vec_type& point, pid_list& nids) const;
+
+  size_t findNeighbors(size_t i, pid_list& nids) const
+  {
+    assert(i < this->_points.size());
+    return findNeighbors(vec_type{this->_points[i]}, nids);
+  }
+
+private:
+  std::vector<point_id> _ids;
+  std::vector<vec_type> _positions;
+  std::vector<id_type> _cellIds;
+  std::vector<point_id> _counts;
+  int _threadCount;
+  bool _reorder;
+
+}; // CompactPointGrid
+
+template <int D, typename real, typename PA, typename ID>
+CompactPointGrid<D, real, PA, ID>::CompactPointGrid
+  (const Bounds<real, D>& bounds,
+  const PA& points,
+  real h,
+  bool reorder,
+  int threadCount):
+  Base{bounds, h},
+  PointSet(points),
+  _threadCount{threadCount},
+  _reorder{reorder}
+{
+  rebuild();
+}
+
+template <int D, typename real, typename PA, typename ID>
+void
+CompactPointGrid<D, real, PA, ID>::rebuild()
+{
+  const auto n = size_t(this->_points.size());
+  const auto m = size_t(this->length());
+  // Each counting thread has a histogram of m cells. Their number is
+  // capped so that the histograms take no more than max(n, m) entries:
+  // a grid with more cells than points is counted by a single thread
+  const auto t = parallelThreads(n / m, _threadCount);
+
+  // Count the points of each cell per thread. Points out of the
+  // bounds of the grid are discarded
+  _cellIds.resize(n);
+  _counts.assign(m * t, 0);
+  parallelFor(n, [this, m](size_t b, size_t e, int t)
+  {
+    auto counts = _counts.data() + m * t;
+
+    for (auto i = b; i < e; ++i)
+    {
+      vec_type p{this->_points[i]};
+
+      if (!this->bounds().contains(p))
+        _cellIds[i] = -1;
+      else
+        ++counts[_cellIds[i] = this->id(p)];
+    }
+  }, t);
+
+  // Compute the offset of each cell and, within a cell, the offset
+  // of the points counted by each thread. The histograms are scanned
+  // one after another, never with a stride of m
+  auto cells = &(*this)[id_type(0)];
+
+  std::fill_n(cells, m, point_id(0));
+  for (auto counts = _counts.begin(); counts != _counts.end(); counts += m)
+    for (size_t c = 0; c < m; ++c)
+      cells[c] += counts[c];
+
+  point_id offset{0};
+
+  for (size_t c = 0; c < m; ++c)
+  {
+    auto count = cells[c];
+
+    cells[c] = offset;
+    offset += count;
+  }
+  for (auto counts = _counts.begin(); counts != _counts.end(); counts += m)
+    for (size_t c = 0; c < m; ++c)
+    {
+      auto count = counts[c];
+
+      counts[c] = cells[c];
+      cells[c] += count;
+    }
+  // Each cell now holds the offset of the next one
+  std::copy_backward(cells, cells + m - 1, cells + m);
+  cells[0] = 0;
+
+  // Scatter the point ids. Each thread scans the same points it
+  // counted, so the sort is stable
+  _ids.resize(offset);
+  parallelFor(n, [this, m](size_t b, size_t e, int t)
+  {
+    auto cursors = _counts.data() + m * t;
+
+    for (auto i = b; i < e; ++i)
+      if (auto c = _cellIds[i]; c >= 0)
+        _ids[cursors[c]++] = point_id(i);
+  }, t);
+  if (!_reorder)
+    _positions.clear();
+  else
+  {
+    _positions.resize(offset);
+    parallelFor(offset, [this](size_t b, size_t e, int)
+    {
+      for (auto j = b; j < e; ++j)
+        _positions[j] = vec_type{this->_points[_ids[j]]};
+    }, _threadCount);
+  }
+}
+
+template <int D, typename real, typename PA, typename ID>
+template <typename F>
+void
+CompactPointGrid<D, real, PA, ID>::forEachNeighbor(const vec_type& point,
+  real radius,
+  F f) const
+{
+  const auto& size = this->size();
+  auto lo = this->floatIndex(point - vec_type{radius});
+  auto hi = this->floatIndex(point + vec_type{radius});
+  index_type s;
+  index_type e;
+
+  for (int i = 0; i < D; ++i)
+  {
+    if (hi[i] < 0 || lo[i] >= real(size[i]))
+      return;
+    s[i] = std::max(id_type(lo[i]), id_type(0));
+    e[i] = std::min(id_type(hi[i]), size[i] - 1);
+  }
+
+  const auto r2 = radius * radius;
+
+  for (auto c = s;;)
+  {
+    // Cells along the first dimension are contiguous in the grid
+    auto b = (*this)[this->id(c)];
+    auto n = range(this->id(c) + e[0] - s[0]).end;
+
+    for (auto j = b; j < n; ++j)
+    {
+      auto d2 = (point - position(j)).squaredNorm();
+
+      if (d2 <= r2)
+        f(_ids[j], d2);
+    }
+
+    int i = 1;
+
+    for (; i < D && ++c[i] > e[i]; ++i)
+      c[i] = s[i];
+    if (i >= D)
+      break;
+  }
+}
+
+template <int D, typename real, typename PA, typename ID>
+size_t
+CompactPointGrid<D, real, PA, ID>::findNeighbors(const vec_type& point,
+  pid_list& nids) const
+{
+  auto h = this->cellSize().min();
+
+  nids.clear();
+  forEachNeighbor(point, h, [&nids](point_id i, real d2)
+  {
+    if (d2 != 0)
+      nids.add(i);
+  });
+  return nids.size();
+}
+
+template <typename real, typename PA, typename ID = int>
+using CompactPointGrid2 = CompactPointGrid<2, real, PA, ID>;
+
+template <typename real, typename PA, typename ID = int>
+using CompactPointGrid3 = CompactPointGrid<3, real, PA, ID>;
+
+} // end namespace cg
+
+#endif // __CompactPointGrid_h
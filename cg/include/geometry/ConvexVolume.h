@@ -0,0 +1,236 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2026 Paulo Pagliosa.                              |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: ConvexVolume.h
+// ========
+// Class definition for convex volume.
+//
+// Author: Paulo Pagliosa
+// Last revision: 19/10/2026
+
+#ifndef __ConvexVolume_h
+#define __ConvexVolume_h
+
+#include "geometry/Bounds3.h"
+#include <cstdint>
+#include <stdexcept>
+
+namespace cg
+{ // begin namespace cg
+
+//
+// Containment of a region (a node of a tree or a range of cells of
+// a grid) in the range of a query
+//
+enum class Containment
+{
+  Outside,
+  Intersect,
+  Inside
+
+}; // Containment
+
+/// Returns the containment of the bounds \p b in the box \p box.
+template <typename real, int D>
+inline Containment
+classify(const Bounds<real, D>& box, const Bounds<real, D>& b)
+{
+  auto inside = true;
+
+  for (int i = 0; i < D; ++i)
+  {
+    if (b[1][i] < box[0][i] || b[0][i] > box[1][i])
+      return Containment::Outside;
+    if (b[0][i] < box[0][i] || b[1][i] > box[1][i])
+      inside = false;
+  }
+  return inside ? Containment::Inside : Containment::Intersect;
+}
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// ConvexVolume: convex volume class
+// ============
+//
+// A convex volume is the intersection of up to maxPlanes closed
+// halfspaces n.p + d >= 0, e.g., a view frustum.
+//
+template <typename real, int D>
+class ConvexVolume
+{
+public:
+  ASSERT_REAL(real, "ConvexVolume: floating point type expected");
+
+  using vec_type = Vector<real, D>;
+  using bounds_type = Bounds<real, D>;
+  using plane_mask = uint32_t;
+
+  static constexpr int maxPlanes = 16;
+
+  struct Plane
+  {
+    vec_type normal;
+    real d;
+
+    auto distance(const vec_type& p) const
+    {
+      return normal.dot(p) + d;
+    }
+
+  }; // Plane
+
+  /// Constructs a ConvexVolume object with no planes.
+  ConvexVolume() = default;
+
+  /// Constructs a ConvexVolume object from the box \p b.
+  explicit ConvexVolume(const bounds_type& b)
+  {
+    for (int i = 0; i < D; ++i)
+    {
+      vec_type n{real(0)};
+
+      n[i] = 1;
+      addPlane(n, -b[0][i]);
+      n[i] = -1;
+      addPlane(n, b[1][i]);
+    }
+  }
+
+  /// \brief Returns the view frustum of the matrix \p m.
+  /// m is a (projection or view-projection) matrix that maps the
+  /// frustum to the clip volume -w <= x, y, z <= w.
+  static ConvexVolume frustum(const Matrix4x4<real>& m);
+
+  auto planeCount() const
+  {
+    return _planeCount;
+  }
+
+  const auto& plane(int i) const
+  {
+    return _planes[i];
+  }
+
+  /// Returns the mask with the bits of all planes of this volume set.
+  plane_mask planes() const
+  {
+    return plane_mask((uint64_t(1) << _planeCount) - 1);
+  }
+
+  void clear()
+  {
+    _planeCount = 0;
+  }
+
+  void addPlane(const vec_type& normal, real d)
+  {
+    if (_planeCount == maxPlanes)
+      throw std::logic_error("ConvexVolume: too many planes");
+    _planes[_planeCount++] = {normal, d};
+  }
+
+  bool contains(const vec_type& p) const
+  {
+    for (int i = 0; i < _planeCount; ++i)
+      if (_planes[i].distance(p) < 0)
+        return false;
+    return true;
+  }
+
+  /// \brief Returns the containment of the bounds \p b in this volume.
+  /// Only the planes in \p mask are tested. On return, \p mask keeps
+  /// only the planes crossed by \p b, which are the planes to be
+  /// tested against the regions inside \p b.
+  Containment classify(const bounds_type& b, plane_mask& mask) const;
+
+private:
+  Plane _planes[maxPlanes];
+  int _planeCount{};
+
+}; // ConvexVolume
+
+template <typename real, int D>
+ConvexVolume<real, D>
+ConvexVolume<real, D>::frustum(const Matrix4x4<real>& m)
+{
+  static_assert(D == 3, "ConvexVolume: 3D volume expected");
+
+  // Each plane is the sum or the difference of the rows 3 and i of m
+  // (column-major), for i = 0 (left/right), 1 (bottom/top) and 2
+  // (near/far)
+  ConvexVolume<real, 3> v;
+
+  for (int i = 0; i < 3; ++i)
+    for (real s : {real(1), real(-1)})
+    {
+      vec_type n;
+
+      for (int j = 0; j < 3; ++j)
+        n[j] = m[j][3] + s * m[j][i];
+
+      auto d = m[3][3] + s * m[3][i];
+      auto l = n.length();
+
+      v.addPlane(n * (1 / l), d / l);
+    }
+  return v;
+}
+
+template <typename real, int D>
+Containment
+ConvexVolume<real, D>::classify(const bounds_type& b, plane_mask& mask) const
+{
+  for (int i = 0; i < _planeCount; ++i)
+  {
+    if ((mask & (1u << i)) == 0)
+      continue;
+
+    const auto& plane = _planes[i];
+    vec_type pMin;
+    vec_type pMax;
+
+    // Corners of b with the min and max distances to the plane
+    for (int j = 0; j < D; ++j)
+    {
+      auto c = plane.normal[j] >= 0;
+
+      pMin[j] = b[!c][j];
+      pMax[j] = b[c][j];
+    }
+    if (plane.distance(pMax) < 0)
+      return Containment::Outside;
+    if (plane.distance(pMin) >= 0)
+      mask &= ~(1u << i);
+  }
+  return mask == 0 ? Containment::Inside : Containment::Intersect;
+}
+
+template <typename real> using ConvexVolume2 = ConvexVolume<real, 2>;
+template <typename real> using ConvexVolume3 = ConvexVolume<real, 3>;
+
+} // end namespace cg
+
+#endif // __ConvexVolume_h
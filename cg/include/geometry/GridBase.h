@@ -28,15 +28,16 @@
 // Class definition for grid base.
 //
 // Author: Paulo Pagliosa
-// Last revision: 12/09/2022
+// Last revision: 19/10/2026
 
 #ifndef __GridBase_h
 #define __GridBase_h
 
 #include "core/ContentHolder.h"
 #include "core/SharedObject.h"
-#include "geometry/Bounds3.h"
+#include "geometry/ConvexVolume.h"
 #include "geometry/Index3.h"
+#include <algorithm>
 #include <cassert>
 #include <stdexcept>
 
@@ -437,11 +438,68 @@ public:
     return bounds(Base::index(id));
   }
 
+  /// Calls f(id, inside) for each cell whose bounds intersect \p box,
+  /// where inside is true if the cell is inside \p box.
+  template <typename F>
+  void forEachCell(const bounds_type& box, F f) const
+  {
+    index_type lo;
+    index_type hi;
+
+    if (cellRange(box, lo, hi))
+    {
+      auto c = [&box](const bounds_type& b, int) { return classify(box, b); };
+      rangeSearch(lo, hi, c, 0, f);
+    }
+  }
+
+  /// Calls f(id, inside) for each cell whose bounds intersect
+  /// \p volume, where inside is true if the cell is inside \p volume.
+  template <typename F>
+  void forEachCell(const ConvexVolume<real, D>& volume, F f) const
+  {
+    auto c = [&volume](const bounds_type& b, auto& mask)
+    {
+      return volume.classify(b, mask);
+    };
+    auto hi = this->size() - 1;
+
+    rangeSearch(index_type{id_type(0)}, hi, c, volume.planes(), f);
+  }
+
 protected:
   bounds_type _bounds;
   vec_type _cellSize;
   vec_type _inverseCellSize;
 
+  // Computes the range [lo, hi] of indices of the cells intersecting
+  // the box b. Returns false if b does not intersect this grid
+  bool cellRange(const bounds_type& b, index_type& lo, index_type& hi) const
+  {
+    const auto& s = this->size();
+    auto p = floatIndex(b[0]);
+    auto q = floatIndex(b[1]);
+
+    for (int i = 0; i < D; ++i)
+    {
+      if (q[i] < 0 || p[i] >= s[i])
+        return false;
+      lo[i] = id_type(std::max(p[i], real(0)));
+      hi[i] = id_type(std::min(q[i], real(s[i] - 1)));
+    }
+    return true;
+  }
+
+  // Visits the cells in the range [lo, hi] not outside the range of
+  // a query given by the classifier c(bounds, state). The range is
+  // split in halves along its largest axis until it is inside or
+  // outside the query range, or it has a single cell
+  template <typename C, typename S, typename F>
+  void rangeSearch(const index_type&, const index_type&, C&, S, F&) const;
+
+  template <typename F>
+  void visitCells(const index_type&, const index_type&, bool, F&) const;
+
 private:
   static real _fatFactor;
 
@@ -450,6 +508,62 @@ private:
 template <int D, typename real, typename T>
 inline real RegionGrid<D, real, T>::_fatFactor = dflFatFactor;
 
+template <int D, typename real, typename T>
+template <typename C, typename S, typename F>
+void
+RegionGrid<D, real, T>::rangeSearch(const index_type& lo,
+  const index_type& hi,
+  C& c,
+  S state,
+  F& f) const
+{
+  auto r = c(bounds_type{basePoint(lo), basePoint(hi + 1)}, state);
+
+  if (r == Containment::Outside)
+    return;
+
+  int axis = 0;
+
+  for (int i = 1; i < D; ++i)
+    if (hi[i] - lo[i] > hi[axis] - lo[axis])
+      axis = i;
+  if (r == Containment::Inside || lo[axis] == hi[axis])
+  {
+    visitCells(lo, hi, r == Containment::Inside, f);
+    return;
+  }
+
+  auto m = (lo[axis] + hi[axis]) / 2;
+  auto h = hi;
+  auto l = lo;
+
+  h[axis] = m;
+  l[axis] = m + 1;
+  rangeSearch(lo, h, c, state, f);
+  rangeSearch(l, hi, c, state, f);
+}
+
+template <int D, typename real, typename T>
+template <typename F>
+void
+RegionGrid<D, real, T>::visitCells(const index_type& lo,
+  const index_type& hi,
+  bool inside,
+  F& f) const
+{
+  for (auto c = lo;;)
+  {
+    f(Base::id(c), inside);
+
+    int i = 0;
+
+    for (; i < D && ++c[i] > hi[i]; ++i)
+      c[i] = lo[i];
+    if (i == D)
+      break;
+  }
+}
+
 namespace internal
 { // begin namespace internal
 
@@ -0,0 +1,301 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2026 Paulo Pagliosa.                              |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: HashedPointGrid.h
+// ========
+// Class definition for hashed point grid.
+//
+// Author: Paulo Pagliosa
+// Last revision: 19/10/2026
+
+#ifndef __HashedPointGrid_h
+#define __HashedPointGrid_h
+
+#include "geometry/Index2.h"
+#include "geometry/Index3.h"
+#include "geometry/IndexList.h"
+#include "geometry/NeighborTable.h"
+#include "geometry/PointHolder.h"
+#include <cmath>
+#include <vector>
+
+namespace cg
+{ // begin namespace cg
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// HashedPointGrid: hashed point grid class
+// ===============
+//
+// Unbounded point grid whose occupied cells are kept in a compact
+// array and found by an open-addressing (linear probing) hash table
+// from cell coordinates to the cell index in that array. The memory
+// used is proportional to the number of occupied cells, and points
+// are never discarded for being out of bounds.
+//
+template <int D, typename real, typename PA, typename IL = IndexList<>>
+class HashedPointGrid: public PointHolder<D, real, PA>
+{
+public:
+  ASSERT_INDEX_LIST(IL, "Index list expected");
+
+  using type = HashedPointGrid<D, real, PA, IL>;
+  using PointSet = PointHolder<D, real, PA>;
+  using point_id = typename IL::value_type;
+  using pid_list = IndexList<point_id>;
+  using vec_type = Vector<real, D>;
+  using id_type = int64_t;
+  using index_type = Index<D, id_type>;
+  using Neighbors = NeighborTable<point_id, real>;
+
+  HashedPointGrid(const PA& points, real h);
+
+  auto cellSize() const
+  {
+    return _cellSize;
+  }
+
+  /// Returns the number of occupied cells.
+  auto cellCount() const
+  {
+    return _cells.size();
+  }
+
+  /// Returns the coordinates of the i-th occupied cell.
+  const auto& cellIndex(size_t i) const
+  {
+    return _keys[i];
+  }
+
+  /// Returns the points of the i-th occupied cell.
+  const auto& cell(size_t i) const
+  {
+    return _cells[i];
+  }
+
+  auto index(const vec_type& p) const
+  {
+    index_type index;
+
+    for (int i = 0; i < D; ++i)
+      index[i] = id_type(std::floor(p[i] * _inverseCellSize));
+    return index;
+  }
+
+  /// Returns the points of the cell with coordinates \p index, or
+  /// null if the cell is empty.
+  const IL* find(const index_type& index) const
+  {
+    auto c = lookup(index);
+    return c < 0 ? nullptr : &_cells[c];
+  }
+
+  const IL* find(const vec_type& p) const
+  {
+    return find(index(p));
+  }
+
+  bool addPoint(point_id i)
+  {
+    assert(i < this->_points.size());
+    return _cells[insert(index(this->_points[i]))].add(i);
+  }
+
+  /// Calls f(id, d2) for each point whose squared distance d2 to
+  /// \p point is not greater than \p radius squared.
+  template <typename F>
+  void forEachNeighbor(const vec_type& point, real radius, F f) const;
+
+  size_t findNeighbors(const vec_type& point, pid_list& nids) const;
+
+  size_t findNeighbors(size_t i, pid_list& nids) const
+  {
+    assert(i < this->_points.size());
+    return findNeighbors(vec_type{this->_points[i]}, nids);
+  }
+
+  /// Finds the points within \p radius of each of the \p n query
+  /// points in parallel (see NeighborTable).
+  void findNeighbors(const vec_type* points,
+    size_t n,
+    real radius,
+    Neighbors& neighbors,
+    bool withDistances = false,
+    int threadCount = 0) const
+  {
+    neighbors.build(n, [&](size_t i, auto f)
+    {
+      forEachNeighbor(points[i], radius, f);
+    }, withDistances, threadCount);
+  }
+
+  /// Removes all points and cells.
+  void clear()
+  {
+    _cells.clear();
+    _keys.clear();
+    std::fill(_table.begin(), _table.end(), -1);
+  }
+
+private:
+  static constexpr size_t minTableSize = 64;
+
+  std::vector<IL> _cells;
+  std::vector<index_type> _keys;
+  // Index of the cell of each slot, or -1 if the slot is empty
+  std::vector<int32_t> _table;
+  real _cellSize;
+  real _inverseCellSize;
+
+  static size_t hash(const index_type& index)
+  {
+    constexpr uint64_t primes[]{73856093, 19349663, 83492791};
+    uint64_t h{0};
+
+    for (int i = 0; i < D; ++i)
+      h ^= uint64_t(index[i]) * primes[i % 3];
+    // Mix the high bits into the low ones used by the table
+    return size_t(h ^ (h >> 29) ^ (h >> 47));
+  }
+
+  auto slot(const index_type& index) const
+  {
+    const auto mask = _table.size() - 1;
+    auto s = hash(index) & mask;
+
+    while (_table[s] >= 0 && !(_keys[_table[s]] == index))
+      s = (s + 1) & mask;
+    return s;
+  }
+
+  int32_t lookup(const index_type& index) const
+  {
+    return _table[slot(index)];
+  }
+
+  int32_t insert(const index_type& index);
+  void rehash(size_t size);
+
+}; // HashedPointGrid
+
+template <int D, typename real, typename PA, typename IL>
+HashedPointGrid<D, real, PA, IL>::HashedPointGrid(const PA& points,
+  real h):
+  PointSet(points),
+  _table(minTableSize, -1)
+{
+  if (h <= 0)
+    throw std::runtime_error("HashedPointGrid: bad cell size");
+  _cellSize = h;
+  _inverseCellSize = math::inverse(h);
+  for (point_id n = points.size(), i = 0; i < n; ++i)
+    _cells[insert(index(points[i]))].add(i);
+}
+
+template <int D, typename real, typename PA, typename IL>
+int32_t
+HashedPointGrid<D, real, PA, IL>::insert(const index_type& index)
+{
+  auto s = slot(index);
+
+  if (_table[s] >= 0)
+    return _table[s];
+  // Keep the load factor below 1/2
+  if (2 * (_cells.size() + 1) > _table.size())
+  {
+    rehash(2 * _table.size());
+    s = slot(index);
+  }
+  _table[s] = int32_t(_cells.size());
+  _keys.push_back(index);
+  _cells.emplace_back();
+  return _table[s];
+}
+
+template <int D, typename real, typename PA, typename IL>
+void
+HashedPointGrid<D, real, PA, IL>::rehash(size_t size)
+{
+  _table.assign(size, -1);
+  for (size_t n = _keys.size(), i = 0; i < n; ++i)
+    _table[slot(_keys[i])] = int32_t(i);
+}
+
+template <int D, typename real, typename PA, typename IL>
+template <typename F>
+void
+HashedPointGrid<D, real, PA, IL>::forEachNeighbor(const vec_type& point,
+  real radius,
+  F f) const
+{
+  const auto s = index(point - vec_type{radius});
+  const auto e = index(point + vec_type{radius});
+  const auto r2 = radius * radius;
+
+  for (auto c = s;;)
+  {
+    for (c[0] = s[0]; c[0] <= e[0]; ++c[0])
+      if (auto cell = lookup(c); cell >= 0)
+        for (auto i : _cells[cell])
+        {
+          auto d2 = (point - this->_points[i]).squaredNorm();
+
+          if (d2 <= r2)
+            f(i, d2);
+        }
+
+    int i = 1;
+
+    for (; i < D && ++c[i] > e[i]; ++i)
+      c[i] = s[i];
+    if (i >= D)
+      break;
+  }
+}
+
+template <int D, typename real, typename PA, typename IL>
+size_t
+HashedPointGrid<D, real, PA, IL>::findNeighbors(const vec_type& point,
+  pid_list& nids) const
+{
+  nids.clear();
+  forEachNeighbor(point, _cellSize, [&nids](point_id i, real d2)
+  {
+    if (d2 != 0)
+      nids.add(i);
+  });
+  return nids.size();
+}
+
+template <typename real, typename PA, typename IL = IndexList<>>
+using HashedPointGrid2 = HashedPointGrid<2, real, PA, IL>;
+
+template <typename real, typename PA, typename IL = IndexList<>>
+using HashedPointGrid3 = HashedPointGrid<3, real, PA, IL>;
+
+} // end namespace cg
+
+#endif // __HashedPointGrid_h
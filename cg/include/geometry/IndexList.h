@@ -28,7 +28,7 @@
 // Class definition for index list.
 //
 // Author: Paulo Pagliosa
-// Last revision: 12/09/2022
+// Last revision: 19/10/2026
 
 #ifndef __IndexList_h
 #define __IndexList_h
@@ -79,6 +79,10 @@ private:
 
 }; // IndexListNode
 
+template <typename T>
+inline constexpr auto memoryCategoryOf<IndexListNode<T>> =
+  MemoryCategory::IndexLists;
+
 namespace il
 { // begin namespace il
 
@@ -239,6 +243,18 @@ public:
 
   iterator remove(iterator i);
 
+  /// Removes the first occurrence of \p index from this list.
+  bool remove(value_type index)
+  {
+    for (auto i = begin(), e = end(); i != e; ++i)
+      if (*i == index)
+      {
+        remove(i);
+        return true;
+      }
+    return false;
+  }
+
   auto removeFront()
   {
     return remove(begin());
@@ -28,44 +28,188 @@
 // Class definition for KNN helper.
 //
 // Author: Paulo Pagliosa
-// Last revision: 12/09/2022
+// Last revision: 19/10/2026
 
 #ifndef __KNNHelper_h
 #define __KNNHelper_h
 
+#include "core/MonotonicArena.h"
+#include "math/Vector3.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
 #include <functional>
 #include <limits>
+#include <type_traits>
 
 namespace cg
 { // begin namespace cg
 
+namespace knn
+{ // begin namespace knn
+
+//
+// Norm policies for KNNHelper. A norm is monotone if it does not
+// decrease when the absolute value of any coordinate of its argument
+// increases. For a monotone norm, the norm of the per-axis gaps from
+// a point to a box is a lower bound of the norm of the vector from
+// the point to any point in the box, which allows searches to prune.
+//
+struct SquaredNorm
+{
+  template <typename real, int D>
+  real operator ()(const Vector<real, D>& v) const
+  {
+    return v.squaredNorm();
+  }
+
+}; // SquaredNorm
+
+struct L1Norm
+{
+  template <typename real, int D>
+  real operator ()(const Vector<real, D>& v) const
+  {
+    real s{0};
+
+    for (int i = 0; i < D; ++i)
+      s += std::abs(v[i]);
+    return s;
+  }
+
+}; // L1Norm
+
+struct LInfNorm
+{
+  template <typename real, int D>
+  real operator ()(const Vector<real, D>& v) const
+  {
+    real s{0};
+
+    for (int i = 0; i < D; ++i)
+      s = std::max(s, real(std::abs(v[i])));
+    return s;
+  }
+
+}; // LInfNorm
+
+//
+// Weighted squared Euclidean norm. The weights must be non-negative,
+// otherwise the norm is not monotone and the pruning of the searches
+// would miss nearest neighbors.
+//
+template <typename Vector>
+class WeightedNorm
+{
+public:
+  using real = typename Vector::value_type;
+
+  WeightedNorm():
+    _weights{real(1)}
+  {
+    // do nothing
+  }
+
+  explicit WeightedNorm(const Vector& weights):
+    _weights{weights}
+  {
+    assert(weights.min() >= 0);
+  }
+
+  const auto& weights() const
+  {
+    return _weights;
+  }
+
+  auto operator ()(const Vector& v) const
+  {
+    return (_weights * v).dot(v);
+  }
+
+private:
+  Vector _weights;
+
+}; // WeightedNorm
+
+template <typename Norm>
+inline constexpr bool isMonotone = false;
+
+template <>
+inline constexpr bool isMonotone<SquaredNorm> = true;
+
+template <>
+inline constexpr bool isMonotone<L1Norm> = true;
+
+template <>
+inline constexpr bool isMonotone<LInfNorm> = true;
+
+// The weights are asserted to be non-negative on construction
+template <typename Vector>
+inline constexpr bool isMonotone<WeightedNorm<Vector>> = true;
+
+} // end namespace knn
+
 
 /////////////////////////////////////////////////////////////////////
 //
 // KNNHelper: KNNHelper class
 // =========
-template <typename Vector, typename Index = int>
+//
+// The norm used to compare distances is a policy (squared Euclidean
+// by default, see namespace knn), so that it can be inlined in the
+// search loops. Norm (a std::function) can still be used as the
+// policy, at the cost of an indirect call per tested point.
+//
+template <typename Vector,
+  typename Index = int,
+  typename NormPolicy = knn::SquaredNorm>
 class KNNHelper
 {
 public:
   using real = typename Vector::value_type;
   using Norm = std::function<real(const Vector&)>;
-
+  using norm_type = NormPolicy;
+
+  /**
+   * \brief Bounded priority queue keeping the k entries with the
+   * smallest keys, organized as a binary max-heap on the key.
+   *
+   * The entries of queues with k <= inlineCapacity are stored in the
+   * queue itself; the ones of larger queues are allocated from the
+   * frame arena of the calling thread (see MonotonicArena). On
+   * destruction, the queue frees only its own block, and only if it is
+   * still the last allocation of the arena; otherwise, the block is
+   * freed when the arena is rewound by its owner.
+   */
   template<typename Value>
   class Queue
   {
   public:
+    static_assert(std::is_trivially_copyable_v<Value>,
+      "KNNHelper: trivially copyable queue values expected");
+
+    static constexpr int inlineCapacity = 32;
+
     Queue(int k):
       _k{k},
-      _n{0},
-      _entries{new Entry[k + 1]}
+      _n{0}
     {
-      // do nothing
+      if (k <= inlineCapacity)
+        _entries = _inlineEntries;
+      else
+      {
+        _arena = &MonotonicArena::frame();
+        _entries = _arena->template allocate<Entry>(k);
+      }
     }
 
+    Queue(const Queue&) = delete;
+    Queue& operator =(const Queue&) = delete;
+
     ~Queue()
     {
-      delete []_entries;
+      if (_arena != nullptr)
+        _arena->free(_entries, _k * sizeof(Entry));
     }
 
     auto key(int i) const
@@ -78,9 +222,11 @@ public:
       return _entries[i].value;
     }
 
+    /// Returns the greatest key if the queue is full, or the maximum
+    /// real otherwise.
     auto maxKey() const
     {
-      return key(_n);
+      return _n < _k ? std::numeric_limits<real>::max() : _entries[0].key;
     }
 
     auto size() const
@@ -90,61 +236,104 @@ public:
 
     bool insert(real key, const Value& value)
     {
-      if (key >= this->key(_k))
+      if (_n < _k)
+      {
+        // Sift up from the last position
+        auto i = _n++;
+
+        for (int p; i > 0 && _entries[p = (i - 1) / 2].key < key; i = p)
+          _entries[i] = _entries[p];
+        _entries[i] = {key, value};
+        return true;
+      }
+      if (_k == 0 || key >= _entries[0].key)
         return false;
 
-      int i;
+      // Replace the root and sift down
+      int i = 0;
 
-      for (i = _n; i > 0; --i)
+      for (int c; (c = 2 * i + 1) < _n; i = c)
       {
-        if (_entries[i - 1].key > key)
-          _entries[i] = _entries[i - 1];
-        else
+        if (c + 1 < _n && _entries[c].key < _entries[c + 1].key)
+          ++c;
+        if (_entries[c].key <= key)
           break;
+        _entries[i] = _entries[c];
       }
-      _entries[i].key = key;
-      _entries[i].value = value;
-      if (_n < _k)
-        ++_n;
+      _entries[i] = {key, value};
       return true;
     }
 
+    /// Sorts the entries in decreasing order of key. A sorted queue
+    /// is still a valid heap.
+    void sort()
+    {
+      std::sort(_entries, _entries + _n, [](const Entry& a, const Entry& b)
+      {
+        return a.key > b.key;
+      });
+    }
+
   private:
     struct Entry
     {
       real key;
       Value value;
 
-      Entry():
-        key{std::numeric_limits<real>::max()}
-      {
-        // do nothing
-      }
-
     }; // Entry
 
     int _k;
     int _n;
     Entry* _entries;
+    MonotonicArena* _arena{};
+    Entry _inlineEntries[inlineCapacity];
 
-  }; // IndexQueue
+  }; // Queue
 
   static real squaredNorm(const Vector& p)
   {
     return p.squaredNorm();
   }
 
-  KNNHelper(const Vector& p, int k, Norm norm = squaredNorm):
+  KNNHelper(const Vector& p, int k, NormPolicy norm = {}):
     _sample{p},
     _queue{k},
     _norm{norm}
   {
-    // do nothing
+    if constexpr (std::is_same_v<NormPolicy, Norm>)
+      if (!_norm)
+        _norm = squaredNorm;
+  }
+
+  void setNorm(NormPolicy norm)
+  {
+    if constexpr (std::is_same_v<NormPolicy, Norm>)
+      _norm = norm ? norm : squaredNorm;
+    else
+      _norm = norm;
   }
 
-  void setNorm(Norm norm)
+  auto norm(const Vector& v) const
   {
-    _norm = norm ? norm : squaredNorm;
+    return _norm(v);
+  }
+
+  /// Returns true if the norm is monotone (see namespace knn). A Norm
+  /// (or a function pointer) is monotone only if it is squaredNorm.
+  bool isMonotoneNorm() const
+  {
+    if constexpr (knn::isMonotone<NormPolicy>)
+      return true;
+    else if constexpr (std::is_same_v<NormPolicy, Norm>)
+    {
+      auto f = _norm.template target<real(*)(const Vector&)>();
+      return f != nullptr && isSquaredNorm(*f);
+    }
+    else if constexpr (std::is_convertible_v<NormPolicy,
+      real(*)(const Vector&)>)
+      return isSquaredNorm(_norm);
+    else
+      return false;
   }
 
   bool test(const Vector&p, Index id)
@@ -168,26 +357,34 @@ public:
     return _queue.maxKey();
   }
 
+  /// Stores the neighbors found in increasing order of distance.
   auto results(Index indices[], real* distances = nullptr) const
   {
     auto k = _queue.size();
 
+    _queue.sort();
     if (distances == nullptr)
       for (auto i = 0; i < k; ++i)
-        indices[i] = _queue.value(i);
+        indices[i] = _queue.value(k - 1 - i);
     else
       for (auto i = 0; i < k; ++i)
       {
-        indices[i] = _queue.value(i);
-        distances[i] = _queue.key(i);
+        indices[i] = _queue.value(k - 1 - i);
+        distances[i] = _queue.key(k - 1 - i);
       }
     return k;
   }
 
 private:
   Vector _sample;
-  Queue<Index> _queue;
-  Norm _norm;
+  mutable Queue<Index> _queue;
+  NormPolicy _norm;
+
+  // squaredNorm of any instantiation of KNNHelper for Vector and Index
+  static bool isSquaredNorm(real (*f)(const Vector&))
+  {
+    return f == squaredNorm || f == KNNHelper<Vector, Index>::squaredNorm;
+  }
 
 }; // KNNHelper
 
@@ -0,0 +1,582 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2026 Paulo Pagliosa.                              |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: LinearPointTree.h
+// ========
+// Class definition for linear point tree.
+//
+// Author: Paulo Pagliosa
+// Last revision: 19/10/2026
+
+#ifndef __LinearPointTree_h
+#define __LinearPointTree_h
+
+#include "core/ParallelFor.h"
+#include "geometry/IndexList.h"
+#include "geometry/KNNHelper.h"
+#include "geometry/NeighborTable.h"
+#include "geometry/Octree.h"
+#include "geometry/PointHolder.h"
+#include "geometry/Quadtree.h"
+#include <vector>
+
+namespace cg
+{ // begin namespace cg
+
+namespace lpt
+{ // begin namespace lpt
+
+/**
+ * \brief Sorts \p keys (and \p values accordingly) by their \p bits
+ * lower bits, using a parallel LSD radix sort with 8-bit digits. The
+ * sort is stable. \p k and \p v are scratch buffers.
+ */
+template <typename ID>
+void
+radixSort(std::vector<uint64_t>& keys,
+  std::vector<ID>& values,
+  std::vector<uint64_t>& k,
+  std::vector<ID>& v,
+  int bits,
+  int threadCount)
+{
+  constexpr int R = 256;
+  const auto n = keys.size();
+  const auto t = parallelThreads(n, threadCount);
+  std::vector<size_t> counts(R * t);
+
+  k.resize(n);
+  v.resize(n);
+  for (int shift = 0; shift < bits; shift += 8)
+  {
+    std::fill(counts.begin(), counts.end(), 0);
+    parallelFor(n, [&](size_t b, size_t e, int t)
+    {
+      auto c = counts.data() + R * t;
+
+      for (auto i = b; i < e; ++i)
+        ++c[(keys[i] >> shift) & (R - 1)];
+    }, t);
+
+    // Skip the pass if all keys have the same digit
+    size_t offset{0};
+    auto same = false;
+
+    for (int d = 0; d < R && !same; ++d)
+    {
+      size_t count{0};
+
+      for (int i = 0; i < t; ++i)
+        count += counts[R * i + d];
+      same = count == n;
+    }
+    if (same)
+      continue;
+    for (int d = 0; d < R; ++d)
+      for (int i = 0; i < t; ++i)
+      {
+        auto count = counts[R * i + d];
+
+        counts[R * i + d] = offset;
+        offset += count;
+      }
+    parallelFor(n, [&](size_t b, size_t e, int t)
+    {
+      auto c = counts.data() + R * t;
+
+      for (auto i = b; i < e; ++i)
+      {
+        auto j = c[(keys[i] >> shift) & (R - 1)]++;
+
+        k[j] = keys[i];
+        v[j] = values[i];
+      }
+    }, t);
+    keys.swap(k);
+    values.swap(v);
+  }
+}
+
+} // end namespace lpt
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// LinearPointTree: linear point tree class
+// ===============
+//
+// Pointerless point tree built from the points sorted by the Morton
+// codes of their keys. The codes interleave the bits of the keys
+// with the same layout used by TreeKey<D>::childIndex(), so the D
+// bits of each level of a code are the index of a child in a
+// PointTree. The nodes are stored in a flat array in breadth-first
+// order; the children of a branch are contiguous and found from the
+// index of the first child and a child mask. The point ids and
+// positions are stored in Morton order, and each node refers to the
+// range of its points.
+//
+// The child links are explicit rather than derived from the key
+// prefixes: finding the range of a child from the sorted codes takes
+// a binary search per child at every visit, whereas the first child
+// and the mask cost a few bytes per node. Queries descend from the
+// root, so no parent links are stored.
+//
+template <int D, typename real, typename PA, typename ID = int>
+class LinearPointTree: public PointHolder<D, real, PA>
+{
+public:
+  using type = LinearPointTree<D, real, PA, ID>;
+  using PointSet = PointHolder<D, real, PA>;
+  using point_id = ID;
+  using pid_list = IndexList<point_id>;
+  using vec_type = Vector<real, D>;
+  using key_type = TreeKey<D>;
+  using bounds_type = Bounds<real, D>;
+  template <typename Norm = knn::SquaredNorm>
+  using KNNT = KNNHelper<vec_type, point_id, Norm>;
+  using KNN = KNNT<>;
+  using Neighbors = NeighborTable<point_id, real>;
+
+  // Number of levels whose Morton codes fit in 63 bits
+  static constexpr uint32_t maxDepth = 63 / D;
+
+  static constexpr auto fatFactor = (real)1.01;
+
+  struct Node
+  {
+    uint32_t begin;
+    uint32_t end;
+    // Index of the first child, or -1 if the node is a leaf
+    int32_t firstChild;
+    uint8_t depth;
+    uint8_t childMask;
+
+    bool isLeaf() const
+    {
+      return firstChild < 0;
+    }
+
+    auto size() const
+    {
+      return end - begin;
+    }
+
+  }; // Node
+
+  LinearPointTree(const bounds_type& bounds,
+    const PA& points,
+    uint32_t splitThreshold = 20,
+    int threadCount = 0);
+
+  LinearPointTree(const PA& points,
+    uint32_t splitThreshold = 20,
+    bool squared = true,
+    int threadCount = 0):
+    type{PointSet::computeBounds(points, squared),
+      points,
+      splitThreshold,
+      threadCount}
+  {
+    // do nothing
+  }
+
+  /// Rebuilds this tree from the current positions of the points.
+  /// Points out of the bounds of the tree are discarded.
+  void rebuild();
+
+  const auto& bounds() const
+  {
+    return _bounds;
+  }
+
+  const auto& nodes() const
+  {
+    return _nodes;
+  }
+
+  auto nodeCount() const
+  {
+    return _nodes.size();
+  }
+
+  auto leafCount() const
+  {
+    return _leafCount;
+  }
+
+  auto depth() const
+  {
+    return _depth;
+  }
+
+  /// Returns the ids of the points in Morton order.
+  const auto& ids() const
+  {
+    return _ids;
+  }
+
+  /// Returns the positions of the points in Morton order.
+  const auto& positions() const
+  {
+    return _positions;
+  }
+
+  template <typename V>
+  auto key(const V& p) const
+  {
+    constexpr auto m = id_type(maxKey);
+    auto k = key_type{(vec_type{p} - _bounds[0]) * _scale};
+
+    for (int i = 0; i < D; ++i)
+      k[i] = std::clamp(k[i], id_type(0), m);
+    return k;
+  }
+
+  static uint64_t mortonCode(const key_type& key)
+  {
+    uint64_t code{0};
+
+    for (uint64_t mask = maxKey / 2 + 1; mask != 0; mask >>= 1)
+      code = code << D | key.childIndex(mask);
+    return code;
+  }
+
+  auto nodeBounds(const key_type& key, uint32_t depth) const
+  {
+    const auto s = nodeSize(depth);
+    const auto p = _bounds[0] + s * vec_type{key};
+
+    return bounds_type{p, p + s};
+  }
+
+  template <typename Norm = knn::SquaredNorm>
+  int findNearestNeighbors(const vec_type& point,
+    int k,
+    point_id indices[],
+    real* distances = nullptr,
+    Norm norm = {}) const;
+
+  /// Calls f(id, d2) for each point whose squared distance d2 to
+  /// \p point is not greater than \p radius squared.
+  template <typename F>
+  void forEachNeighbor(const vec_type& point, real radius, F f) const;
+
+  size_t findNeighbors(const vec_type& point,
+    real radius,
+    pid_list& list) const
+  {
+    list.clear();
+    forEachNeighbor(point, radius, [&list](point_id i, real)
+    {
+      list.add(i);
+    });
+    return list.size();
+  }
+
+  size_t findNeighbors(int i, real radius, pid_list& list) const
+  {
+    return findNeighbors(vec_type{this->_points[i]}, radius, list);
+  }
+
+  /// Finds the points within \p radius of each of the \p n query
+  /// points in parallel (see NeighborTable).
+  void findNeighbors(const vec_type* points,
+    size_t n,
+    real radius,
+    Neighbors& neighbors,
+    bool withDistances = false,
+    int threadCount = 0) const
+  {
+    neighbors.build(n, [&](size_t i, auto f)
+    {
+      forEachNeighbor(points[i], radius, f);
+    }, withDistances, threadCount);
+  }
+
+private:
+  using id_type = typename key_type::base_type;
+
+  static constexpr auto N = (int)ipow2<D>();
+  static constexpr auto maxKey = uint64_t(-1) >> (64 - maxDepth);
+  // Enough for a depth-first traversal pushing all children of a node
+  static constexpr auto stackSize = maxDepth * (N - 1) + 1;
+
+  struct StackEntry
+  {
+    uint32_t node;
+    key_type key;
+    real d2;
+
+  }; // StackEntry
+
+  bounds_type _bounds;
+  vec_type _resolution;
+  vec_type _scale;
+  std::vector<Node> _nodes;
+  std::vector<point_id> _ids;
+  std::vector<vec_type> _positions;
+  std::vector<uint64_t> _codes;
+  size_t _leafCount{};
+  uint32_t _depth{};
+  uint32_t _splitThreshold;
+  int _threadCount;
+
+  auto nodeSize(uint32_t depth) const
+  {
+    return _resolution * real(uint64_t(1) << (maxDepth - depth));
+  }
+
+  // Returns the per-axis gaps from p to the bounds of a node
+  auto gaps(const vec_type& p, const key_type& key, uint32_t depth) const
+  {
+    auto b = nodeBounds(key, depth);
+    vec_type g;
+
+    for (int i = 0; i < D; ++i)
+      g[i] = std::max({b[0][i] - p[i], p[i] - b[1][i], real(0)});
+    return g;
+  }
+
+  void buildNodes();
+
+}; // LinearPointTree
+
+template <int D, typename real, typename PA, typename ID>
+LinearPointTree<D, real, PA, ID>::LinearPointTree(const bounds_type& bounds,
+  const PA& points,
+  uint32_t splitThreshold,
+  int threadCount):
+  PointSet(points),
+  _bounds{bounds},
+  _splitThreshold{std::max(splitThreshold, 1u)},
+  _threadCount{threadCount}
+{
+  _bounds.inflate(fatFactor);
+  _resolution = _bounds.size() * (1 / real(maxKey + 1));
+  _scale = _resolution.inverse();
+  rebuild();
+}
+
+template <int D, typename real, typename PA, typename ID>
+void
+LinearPointTree<D, real, PA, ID>::rebuild()
+{
+  const auto n = size_t(this->_points.size());
+
+  // Compute the Morton codes of the points in the bounds
+  _codes.resize(n);
+  _ids.resize(n);
+  parallelFor(n, [this](size_t b, size_t e, int)
+  {
+    for (auto i = b; i < e; ++i)
+    {
+      vec_type p{this->_points[i]};
+
+      _ids[i] = point_id(i);
+      _codes[i] = _bounds.contains(p) ? mortonCode(key(p)) : uint64_t(-1);
+    }
+  }, _threadCount);
+
+  std::vector<uint64_t> k;
+  std::vector<point_id> v;
+
+  // Points out of the bounds are sorted last, since the codes of the
+  // points in the bounds have at most 63 bits
+  lpt::radixSort(_codes, _ids, k, v, 64, _threadCount);
+  while (!_codes.empty() && _codes.back() == uint64_t(-1))
+  {
+    _codes.pop_back();
+    _ids.pop_back();
+  }
+  _positions.resize(_ids.size());
+  parallelFor(_ids.size(), [this](size_t b, size_t e, int)
+  {
+    for (auto i = b; i < e; ++i)
+      _positions[i] = vec_type{this->_points[_ids[i]]};
+  }, _threadCount);
+  buildNodes();
+}
+
+template <int D, typename real, typename PA, typename ID>
+void
+LinearPointTree<D, real, PA, ID>::buildNodes()
+{
+  _nodes.clear();
+  _nodes.push_back({0, uint32_t(_codes.size()), -1, 0, 0});
+  _leafCount = 0;
+  _depth = 0;
+  for (size_t i = 0; i < _nodes.size(); ++i)
+  {
+    auto node = _nodes[i];
+
+    if (node.size() <= _splitThreshold || node.depth == maxDepth)
+    {
+      ++_leafCount;
+      continue;
+    }
+
+    // The points of the children are consecutive ranges of the
+    // points of the node, sorted by child index
+    const auto shift = D * (maxDepth - node.depth - 1);
+    auto first = _codes.begin() + node.begin;
+    auto last = _codes.begin() + node.end;
+    uint8_t mask{0};
+
+    _nodes[i].firstChild = int32_t(_nodes.size());
+    for (auto b = first; b != last;)
+    {
+      auto c = (*b >> shift) & (N - 1);
+      auto e = std::upper_bound(b, last, *b, [shift](auto x, auto y)
+      {
+        return (x >> shift) < (y >> shift);
+      });
+
+      mask |= uint8_t(1 << c);
+      _nodes.push_back({uint32_t(b - _codes.begin()),
+        uint32_t(e - _codes.begin()),
+        -1,
+        uint8_t(node.depth + 1),
+        0});
+      b = e;
+    }
+    _nodes[i].childMask = mask;
+    _depth = std::max(_depth, uint32_t(node.depth + 1));
+  }
+}
+
+template <int D, typename real, typename PA, typename ID>
+template <typename F>
+void
+LinearPointTree<D, real, PA, ID>::forEachNeighbor(const vec_type& point,
+  real radius,
+  F f) const
+{
+  if (radius <= 0 || _codes.empty())
+    return;
+
+  const auto r2 = radius * radius;
+  StackEntry stack[stackSize];
+  int top = 0;
+
+  stack[top++] = {0, key_type{id_type(0)}, 0};
+  while (top > 0)
+  {
+    auto e = stack[--top];
+    const auto& node = _nodes[e.node];
+
+    if (node.isLeaf())
+    {
+      for (auto j = node.begin; j < node.end; ++j)
+        if (auto d2 = (point - _positions[j]).squaredNorm(); d2 <= r2)
+          f(_ids[j], d2);
+      continue;
+    }
+
+    auto child = uint32_t(node.firstChild);
+
+    for (int i = 0; i < N; ++i)
+      if (node.childMask & (1 << i))
+      {
+        auto key = key_type(e.key).pushChild(i);
+
+        if (gaps(point, key, node.depth + 1).squaredNorm() <= r2)
+          stack[top++] = {child, key, 0};
+        ++child;
+      }
+  }
+}
+
+template <int D, typename real, typename PA, typename ID>
+template <typename Norm>
+int
+LinearPointTree<D, real, PA, ID>::findNearestNeighbors(const vec_type& p,
+  int k,
+  point_id indices[],
+  real* distances,
+  Norm norm) const
+{
+  KNNT<Norm> knn{p, k, norm};
+  auto n = _positions.size();
+
+  // Nodes can only be pruned if the norm is monotone; otherwise, all
+  // points are tested
+  if (n <= size_t(k) || !knn.isMonotoneNorm())
+  {
+    for (size_t j = 0; j < n; ++j)
+      knn.test(_positions[j], _ids[j]);
+    return knn.results(indices, distances);
+  }
+
+  // Depth-first search visiting the nearest children first
+  StackEntry stack[stackSize];
+  int top = 0;
+
+  stack[top++] = {0, key_type{id_type(0)}, 0};
+  while (top > 0)
+  {
+    auto e = stack[--top];
+
+    if (e.d2 >= knn.maxSquaredDistance())
+      continue;
+
+    const auto& node = _nodes[e.node];
+
+    if (node.isLeaf())
+    {
+      for (auto j = node.begin; j < node.end; ++j)
+        knn.test(_positions[j], _ids[j]);
+      continue;
+    }
+
+    auto child = uint32_t(node.firstChild);
+    auto first = top;
+
+    for (int i = 0; i < N; ++i)
+      if (node.childMask & (1 << i))
+      {
+        auto key = key_type(e.key).pushChild(i);
+        auto d2 = knn.norm(gaps(p, key, node.depth + 1));
+
+        if (d2 < knn.maxSquaredDistance())
+          stack[top++] = {child, key, d2};
+        ++child;
+      }
+    std::sort(stack + first, stack + top, [](const auto& a, const auto& b)
+    {
+      return a.d2 > b.d2;
+    });
+  }
+  return knn.results(indices, distances);
+}
+
+template <typename real, typename PA, typename ID = int>
+using LinearPointQuadtree = LinearPointTree<2, real, PA, ID>;
+
+template <typename real, typename PA, typename ID = int>
+using LinearPointOctree = LinearPointTree<3, real, PA, ID>;
+
+} // end namespace cg
+
+#endif // __LinearPointTree_h
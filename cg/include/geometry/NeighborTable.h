@@ -0,0 +1,220 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2026 Paulo Pagliosa.                              |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: NeighborTable.h
+// ========
+// Class definition for neighbor table.
+//
+// Author: Paulo Pagliosa
+// Last revision: 19/10/2026
+
+#ifndef __NeighborTable_h
+#define __NeighborTable_h
+
+#include "core/ParallelFor.h"
+#include <cassert>
+#include <vector>
+
+namespace cg
+{ // begin namespace cg
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// NeighborTable: neighbor table class
+// =============
+//
+// Neighborhoods of a batch of queries in CSR form: the ids of the
+// neighbors of the i-th query are ids()[offsets()[i]] up to (but not
+// including) ids()[offsets()[i + 1]]. Optionally, the squared
+// distances of the neighbors are stored in the same order.
+//
+template <typename ID, typename real>
+class NeighborTable
+{
+public:
+  using point_id = ID;
+
+  /// Returns the number of queries.
+  auto size() const
+  {
+    return _offsets.empty() ? size_t(0) : _offsets.size() - 1;
+  }
+
+  /// Returns the total number of neighbors.
+  auto neighborCount() const
+  {
+    return _ids.size();
+  }
+
+  auto count(size_t i) const
+  {
+    assert(i < size());
+    return _offsets[i + 1] - _offsets[i];
+  }
+
+  auto begin(size_t i) const
+  {
+    assert(i < size());
+    return _ids.data() + _offsets[i];
+  }
+
+  auto end(size_t i) const
+  {
+    assert(i < size());
+    return _ids.data() + _offsets[i + 1];
+  }
+
+  /// Returns the squared distances of the neighbors of the i-th
+  /// query, or null if the table has no distances.
+  auto distances(size_t i) const
+  {
+    assert(i < size());
+    return hasDistances() ? _distances.data() + _offsets[i] : nullptr;
+  }
+
+  bool hasDistances() const
+  {
+    return _withDistances;
+  }
+
+  const auto& offsets() const
+  {
+    return _offsets;
+  }
+
+  const auto& ids() const
+  {
+    return _ids;
+  }
+
+  const auto& distances() const
+  {
+    return _distances;
+  }
+
+  void clear()
+  {
+    _withDistances = false;
+    _offsets.clear();
+    _ids.clear();
+    _distances.clear();
+  }
+
+  /**
+   * \brief Fills this table with the neighbors of \p n queries in
+   * parallel. search(i, f) must call f(id, d2) for each neighbor id
+   * of the i-th query, where d2 is its squared distance to the query.
+   *
+   * Each thread collects the neighbors of a contiguous range of
+   * queries in its own buffers, which are then copied to the table.
+   * The memory of the table is reused by subsequent builds.
+   */
+  template <typename Search>
+  void build(size_t n,
+    Search search,
+    bool withDistances = false,
+    int threadCount = 0);
+
+private:
+  struct Buffer
+  {
+    std::vector<ID> ids;
+    std::vector<real> distances;
+    size_t begin;
+
+  }; // Buffer
+
+  std::vector<size_t> _offsets;
+  std::vector<ID> _ids;
+  std::vector<real> _distances;
+  std::vector<Buffer> _buffers;
+  bool _withDistances{};
+
+}; // NeighborTable
+
+template <typename ID, typename real>
+template <typename Search>
+void
+NeighborTable<ID, real>::build(size_t n,
+  Search search,
+  bool withDistances,
+  int threadCount)
+{
+  auto t = parallelThreads(n, threadCount);
+
+  _withDistances = withDistances;
+  _offsets.resize(n + 1);
+  _offsets[0] = 0;
+  _buffers.resize(t);
+  parallelFor(n, [&](size_t b, size_t e, int t)
+  {
+    auto& buffer = _buffers[t];
+
+    buffer.ids.clear();
+    buffer.distances.clear();
+    buffer.begin = b;
+    for (auto i = b; i < e; ++i)
+    {
+      auto first = buffer.ids.size();
+
+      if (withDistances)
+        search(i, [&buffer](ID id, real d2)
+        {
+          buffer.ids.push_back(id);
+          buffer.distances.push_back(d2);
+        });
+      else
+        search(i, [&buffer](ID id, real)
+        {
+          buffer.ids.push_back(id);
+        });
+      _offsets[i + 1] = buffer.ids.size() - first;
+    }
+  }, t);
+  for (size_t i = 0; i < n; ++i)
+    _offsets[i + 1] += _offsets[i];
+  _ids.resize(_offsets[n]);
+  _distances.resize(withDistances ? _offsets[n] : 0);
+
+  // The neighbors of a thread are contiguous in the table
+  parallelFor(t, [this](size_t b, size_t e, int)
+  {
+    for (auto i = b; i < e; ++i)
+    {
+      const auto& buffer = _buffers[i];
+      auto o = _offsets[buffer.begin];
+
+      std::copy(buffer.ids.begin(), buffer.ids.end(), _ids.begin() + o);
+      std::copy(buffer.distances.begin(),
+        buffer.distances.end(),
+        _distances.begin() + o);
+    }
+  }, t);
+}
+
+} // end namespace cg
+
+#endif // __NeighborTable_h
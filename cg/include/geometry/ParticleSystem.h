@@ -28,7 +28,7 @@
 // Class definition for particle system.
 //
 // Author: Paulo Pagliosa
-// Last revision: 19/09/2022
+// Last revision: 19/10/2026
 
 #ifndef __ParticleSystem_h
 #define __ParticleSystem_h
@@ -53,6 +53,9 @@ public:
   using Data = SoA<Allocator, index_t, Vector, Args...>;
   using type = ParticleSystem<Allocator, index_t, Vector, Args...>;
 
+  /// Alignment guaranteed for the particle arrays (see SoA).
+  static constexpr auto alignment = Data::alignment;
+
   ParticleSystem() = default;
 
   ParticleSystem(index_t capacity):
@@ -28,15 +28,19 @@
 // Class definition for point grid base.
 //
 // Author: Paulo Pagliosa
-// Last revision: 12/09/2022
+// Last revision: 19/10/2026
 
 #ifndef __PointGridBase_h
 #define __PointGridBase_h
 
+#include "core/ParallelFor.h"
 #include "geometry/GridBase.h"
 #include "geometry/IndexList.h"
 #include "geometry/KNNHelper.h"
+#include "geometry/NeighborTable.h"
 #include "geometry/PointHolder.h"
+#include <algorithm>
+#include <vector>
 
 namespace cg
 { // begin namespace cg
@@ -90,8 +94,12 @@ public:
   using point_id = typename IL::value_type;
   using pid_list = IndexList<point_id>;
   using vec_type = Vector<real, D>;
-  using KNN = KNNHelper<vec_type, point_id>;
+  using bounds_type = Bounds<real, D>;
+  template <typename Norm = knn::SquaredNorm>
+  using KNNT = KNNHelper<vec_type, point_id, Norm>;
+  using KNN = KNNT<>;
   using Searcher = PointGridSearcher<D, real, PA, pid_list>;
+  using Neighbors = NeighborTable<point_id, real>;
 
   PointGrid(const Bounds<real, D>& bounds, const PA& points, real h);
 
@@ -105,14 +113,36 @@ public:
   PointGrid(PointGrid<D, real, P, IL>&& other, const PA& points):
     Base{std::move(other), points}
   {
-    // do nothing
+    auto n = points.size();
+
+    _cellIds.resize(n);
+    for (decltype(n) i = 0; i < n; ++i)
+      _cellIds[i] = cellId(this->_points[i]);
   }
 
+  template <typename Norm = knn::SquaredNorm>
   int findNearestNeighbors(const vec_type& point,
     int k,
     point_id indices[],
     real* distances = nullptr,
-    typename KNN::Norm norm = KNN::squaredNorm) const;
+    Norm norm = {}) const;
+
+  /**
+   * \brief Finds the \p k nearest neighbors of each of the \p n
+   * query points in parallel, using \p threadCount threads (0 for
+   * the number of hardware threads).
+   *
+   * The neighbors of the i-th query are stored from indices[i * k]
+   * (and distances[i * k], if not null), and their number in
+   * counts[i].
+   */
+  void findNearestNeighbors(const vec_type* points,
+    size_t n,
+    int k,
+    point_id indices[],
+    int counts[],
+    real* distances = nullptr,
+    int threadCount = 0) const;
 
   size_t findNeighbors(const vec_type& point, pid_list& nids) const
   {
@@ -125,20 +155,112 @@ public:
     return findNeighbors(vec_type{this->_points[i]}, nids);
   }
 
+  /// Calls f(id, d2) for each point whose squared distance d2 to
+  /// \p point is not greater than \p radius squared.
+  template <typename F>
+  void forEachNeighbor(const vec_type& point, real radius, F f) const;
+
+  /// Calls f(id) for each point inside \p box.
+  template <typename F>
+  void forEachPoint(const bounds_type& box, F f) const
+  {
+    this->forEachCell(box, [&](auto id, bool inside)
+    {
+      for (auto i : (*this)[id])
+        if (inside || box.contains(vec_type{this->_points[i]}))
+          f(i);
+    });
+  }
+
+  /// Calls f(id) for each point inside \p volume.
+  template <typename F>
+  void forEachPoint(const ConvexVolume<real, D>& volume, F f) const
+  {
+    this->forEachCell(volume, [&](auto id, bool inside)
+    {
+      for (auto i : (*this)[id])
+        if (inside || volume.contains(vec_type{this->_points[i]}))
+          f(i);
+    });
+  }
+
+  /// Finds the points within \p radius of each of the \p n query
+  /// points in parallel (see NeighborTable).
+  void findNeighbors(const vec_type* points,
+    size_t n,
+    real radius,
+    Neighbors& neighbors,
+    bool withDistances = false,
+    int threadCount = 0) const
+  {
+    neighbors.build(n, [&](size_t i, auto f)
+    {
+      forEachNeighbor(points[i], radius, f);
+    }, withDistances, threadCount);
+  }
+
   bool addPoint(point_id i)
   {
     assert(i < this->_points.size());
     return addPoint(this->_points[i], i);
   }
 
+  /// Moves point i to the cell of its current position, if that cell
+  /// changed. Returns true if the point was moved.
+  bool update(point_id i);
+
+  /// Moves the points whose cells changed since they were added or
+  /// updated, using \p threadCount threads (0 for the number of
+  /// hardware threads). Points never added are added, as by update().
+  /// Returns the number of moved points.
+  size_t updateMoved(int threadCount = 0);
+
 protected:
+  using id_type = typename Base::id_type;
+  using index_type = typename Base::index_type;
+
   bool addPoint(const vec_type& point, point_id i)
   {
-    if (this->bounds().contains(point))
-      return (*this)[this->id(point)].add(i);
-    return false;
+    auto c = cellId(point);
+
+    if (size_t(i) >= _cellIds.size())
+      _cellIds.resize(i + 1, -1);
+    if ((_cellIds[i] = c) < 0)
+      return false;
+    return (*this)[c].add(i);
+  }
+
+private:
+  struct Move
+  {
+    point_id i;
+    id_type from;
+    id_type to;
+
+  }; // Move
+
+  // Cell of each point, or -1 if the point is out of the grid
+  std::vector<id_type> _cellIds;
+  std::vector<std::vector<Move>> _moves;
+
+  id_type cellId(const vec_type& p) const
+  {
+    return this->bounds().contains(p) ? this->id(p) : -1;
   }
 
+  template <typename K>
+  void testCell(K& knn, const index_type& c) const
+  {
+    for (auto i : (*this)[c])
+      knn.test(this->_points[i], i);
+  }
+
+  template <typename K>
+  void testShell(K&, const index_type&, id_type) const;
+
+  template <typename K>
+  real shellDistance(const K&, const index_type&, id_type) const;
+
 }; // PointGrid
 
 template <int D, typename real, typename PA, typename IL>
@@ -147,36 +269,288 @@ PointGrid<D, real, PA, IL>::PointGrid(const Bounds<real, D>& bounds,
   real h):
   Base{bounds, points, h}
 {
+  _cellIds.resize(points.size(), -1);
   for (point_id n = points.size(), i = 0; i < n; ++i)
     addPoint(points[i], i);
 }
 
 template <int D, typename real, typename PA, typename IL>
+bool
+PointGrid<D, real, PA, IL>::update(point_id i)
+{
+  assert(i < this->_points.size());
+  if (size_t(i) >= _cellIds.size())
+    _cellIds.resize(i + 1, -1);
+
+  auto from = _cellIds[i];
+  auto to = cellId(this->_points[i]);
+
+  if (from == to)
+    return false;
+  if (from >= 0)
+    (*this)[from].remove(i);
+  if ((_cellIds[i] = to) >= 0)
+    (*this)[to].add(i);
+  return true;
+}
+
+template <int D, typename real, typename PA, typename IL>
+size_t
+PointGrid<D, real, PA, IL>::updateMoved(int threadCount)
+{
+  const auto n = size_t(this->_points.size());
+  const auto t = parallelThreads(n, threadCount);
+
+  // Find the moved points. Points never added (e.g., appended to the
+  // point array after the grid was built) are added, if in the grid.
+  // The k-th thread will update the cells whose id modulo the number
+  // of threads is k, so cells are never shared: the moves found by
+  // the s-th thread are bucketed by owner in _moves[s * t + k]
+  std::vector<size_t> counts(t);
+
+  _cellIds.resize(n, -1);
+  _moves.resize(size_t(t) * t);
+  parallelFor(n, [this, t, &counts](size_t b, size_t e, int s)
+  {
+    auto moves = _moves.begin() + size_t(s) * t;
+    size_t count{0};
+
+    for (int k = 0; k < t; ++k)
+      moves[k].clear();
+    for (auto i = b; i < e; ++i)
+      if (auto to = cellId(this->_points[i]); to != _cellIds[i])
+      {
+        auto from = _cellIds[i];
+        auto kf = from >= 0 ? int(from % t) : -1;
+        auto kt = to >= 0 ? int(to % t) : -1;
+
+        if (kf == kt)
+          moves[kf].push_back({point_id(i), from, to});
+        else
+        {
+          if (kf >= 0)
+            moves[kf].push_back({point_id(i), from, -1});
+          if (kt >= 0)
+            moves[kt].push_back({point_id(i), -1, to});
+        }
+        _cellIds[i] = to;
+        ++count;
+      }
+    counts[s] = count;
+  }, t);
+
+  size_t count{0};
+
+  for (auto c : counts)
+    count += c;
+  if (count == 0)
+    return 0;
+
+  // Move the points. Each thread only scans the buckets it owns
+  parallelFor(t, [this, t](size_t b, size_t e, int)
+  {
+    for (auto k = b; k < e; ++k)
+      for (int s = 0; s < t; ++s)
+        for (const auto& move : _moves[s * t + k])
+        {
+          if (move.from >= 0)
+            (*this)[move.from].remove(move.i);
+          if (move.to >= 0)
+            (*this)[move.to].add(move.i);
+        }
+  }, int(std::min(count, size_t(t))));
+  return count;
+}
+
+template <int D, typename real, typename PA, typename IL>
+template <typename F>
+void
+PointGrid<D, real, PA, IL>::forEachNeighbor(const vec_type& point,
+  real radius,
+  F f) const
+{
+  const auto& size = this->size();
+  auto lo = this->floatIndex(point - vec_type{radius});
+  auto hi = this->floatIndex(point + vec_type{radius});
+  index_type s;
+  index_type e;
+
+  for (int i = 0; i < D; ++i)
+  {
+    if (hi[i] < 0 || lo[i] >= real(size[i]))
+      return;
+    s[i] = std::max(id_type(lo[i]), id_type(0));
+    e[i] = std::min(id_type(hi[i]), size[i] - 1);
+  }
+
+  const auto r2 = radius * radius;
+
+  for (auto c = s;;)
+  {
+    for (auto id = this->id(c), n = id + e[0] - s[0]; id <= n; ++id)
+      for (auto i : (*this)[id])
+      {
+        auto d2 = (point - this->_points[i]).squaredNorm();
+
+        if (d2 <= r2)
+          f(i, d2);
+      }
+
+    int i = 1;
+
+    for (; i < D && ++c[i] > e[i]; ++i)
+      c[i] = s[i];
+    if (i >= D)
+      break;
+  }
+}
+
+template <int D, typename real, typename PA, typename IL>
+template <typename K>
+void
+PointGrid<D, real, PA, IL>::testShell(K& knn,
+  const index_type& s,
+  id_type r) const
+{
+  // Visit the cells c such that max(|c[i] - s[i]|) == r
+  const auto& size = this->size();
+  index_type lo;
+  index_type hi;
+
+  for (int i = 0; i < D; ++i)
+  {
+    lo[i] = std::max(s[i] - r, id_type(0));
+    hi[i] = std::min(s[i] + r, size[i] - 1);
+  }
+  for (auto c = lo;;)
+  {
+    auto onShell = false;
+
+    for (int i = 1; i < D; ++i)
+      if (c[i] == s[i] - r || c[i] == s[i] + r)
+      {
+        onShell = true;
+        break;
+      }
+    if (onShell)
+      for (c[0] = lo[0]; c[0] <= hi[0]; ++c[0])
+        testCell(knn, c);
+    else
+    {
+      // Only the first and last cells of the row are on the shell
+      if ((c[0] = s[0] - r) >= 0)
+        testCell(knn, c);
+      if (r > 0 && (c[0] = s[0] + r) < size[0])
+        testCell(knn, c);
+    }
+
+    int i = 1;
+
+    for (; i < D && ++c[i] > hi[i]; ++i)
+      c[i] = lo[i];
+    if (i == D)
+      break;
+  }
+}
+
+template <int D, typename real, typename PA, typename IL>
+template <typename K>
+real
+PointGrid<D, real, PA, IL>::shellDistance(const K& knn,
+  const index_type& s,
+  id_type r) const
+{
+  // Norm of the distance from the sample to the boundary of the box
+  // of cells inside the shell r. For a monotone norm, this is a lower
+  // bound of the distance from the sample to the shell. Returns 0 if
+  // the sample is not inside the box
+  const auto& p = knn.sample();
+  auto lo = this->basePoint(s - (r - 1));
+  auto hi = this->basePoint(s + r);
+  auto d = std::numeric_limits<real>::max();
+
+  for (int i = 0; i < D; ++i)
+  {
+    auto g = std::min(p[i] - lo[i], hi[i] - p[i]);
+
+    if (g <= 0)
+      return 0;
+
+    vec_type v{real(0)};
+
+    v[i] = g;
+    d = std::min(d, knn.norm(v));
+  }
+  return d;
+}
+
+template <int D, typename real, typename PA, typename IL>
+template <typename Norm>
 int
 PointGrid<D, real, PA, IL>::findNearestNeighbors(const vec_type& p,
   int k,
   point_id indices[],
   real* distances,
-  typename KNN::Norm norm) const
+  Norm norm) const
 {
-  /*
-  if (!this->bounds().contains(p))
-    return 0;
-  */
-
-  KNN knn{p, k, norm};
+  KNNT<Norm> knn{p, k, norm};
   auto n = this->_points.size();
 
-  if (n <= k)
-    for (int i = 0; i < n; ++i)
+  // Shells can only be pruned if the norm is monotone; otherwise,
+  // all points are tested
+  if (n <= k || !knn.isMonotoneNorm())
+    for (point_id i = 0; i < n; ++i)
       knn.test(this->_points[i], i);
   else
   {
-    // TODO
+    // Search shells of cells around the cell of p (clamped to the
+    // grid), until the distance from p to the next shell is greater
+    // than the distance to the current k-th neighbor
+    const auto& size = this->size();
+    auto s = this->index(p);
+    id_type maxRadius{};
+
+    for (int i = 0; i < D; ++i)
+    {
+      s[i] = std::clamp(s[i], id_type(0), size[i] - 1);
+      maxRadius = std::max({maxRadius, s[i], size[i] - 1 - s[i]});
+    }
+    for (id_type r = 0; r <= maxRadius; ++r)
+    {
+      if (r > 0)
+        if (auto d = shellDistance(knn, s, r); d > 0)
+          if (d >= knn.maxSquaredDistance())
+            break;
+      testShell(knn, s, r);
+    }
   }
   return knn.results(indices, distances);
 }
 
+template <int D, typename real, typename PA, typename IL>
+void
+PointGrid<D, real, PA, IL>::findNearestNeighbors(const vec_type* points,
+  size_t n,
+  int k,
+  point_id indices[],
+  int counts[],
+  real* distances,
+  int threadCount) const
+{
+  parallelFor(n, [&](size_t b, size_t e, int)
+  {
+    for (auto i = b; i < e; ++i)
+    {
+      auto o = i * k;
+
+      counts[i] = findNearestNeighbors(points[i],
+        k,
+        indices + o,
+        distances != nullptr ? distances + o : nullptr);
+    }
+  }, threadCount);
+}
+
 } // namespace cg
 
 #endif // __PointGridBase_h
@@ -28,15 +28,18 @@
 // Class definition for point quadtree/octree base.
 //
 // Author: Paulo Pagliosa
-// Last revision: 12/09/2022
+// Last revision: 19/10/2026
 
 #ifndef __PointTreeBase_h
 #define __PointTreeBase_h
 
 #include "geometry/IndexList.h"
 #include "geometry/KNNHelper.h"
+#include "geometry/NeighborTable.h"
 #include "geometry/PointHolder.h"
 #include "geometry/TreeBase.h"
+#include <algorithm>
+#include <vector>
 
 namespace cg
 { // begin namespace cg
@@ -92,7 +95,10 @@ public:
   using vec_type = Vector<real, D>;
   using key_type = TreeKey<D>;
   using bounds_type = Bounds<real, D>;
-  using KNN = KNNHelper<vec_type, point_id>;
+  template <typename Norm = knn::SquaredNorm>
+  using KNNT = KNNHelper<vec_type, point_id, Norm>;
+  using KNN = KNNT<>;
+  using Neighbors = NeighborTable<point_id, real>;
 
   using SplitTest = std::function<bool(const PA&, IL&, uint32_t)>;
 
@@ -158,11 +164,12 @@ public:
     build(fullTree);
   }
 
+  template <typename Norm = knn::SquaredNorm>
   int findNearestNeighbors(const vec_type& point,
     int k,
     point_id indices[],
     real* distances = nullptr,
-    typename KNN::Norm norm = KNN::squaredNorm) const;
+    Norm norm = {}) const;
 
   size_t findNeighbors(const vec_type& point,
     real radius,
@@ -173,6 +180,54 @@ public:
     return findNeighbors(vec_type{this->_points[i]}, radius, list);
   }
 
+  /// Calls f(id, d2) for each point whose squared distance d2 to
+  /// \p point is not greater than \p radius squared.
+  template <typename F>
+  void forEachNeighbor(const vec_type& point, real radius, F f) const
+  {
+    if (radius > 0)
+      radiusSearch(point, radius * radius, key_type{0LL}, this->root(), f);
+  }
+
+  /// Calls f(id) for each point inside \p box.
+  template <typename F>
+  void forEachPoint(const bounds_type& box, F f) const
+  {
+    this->forEachLeaf(box, [&](const auto& leaf, bool inside)
+    {
+      for (auto i : leaf.data())
+        if (inside || box.contains(vec_type{this->_points[i]}))
+          f(i);
+    });
+  }
+
+  /// Calls f(id) for each point inside \p volume.
+  template <typename F>
+  void forEachPoint(const ConvexVolume<real, D>& volume, F f) const
+  {
+    this->forEachLeaf(volume, [&](const auto& leaf, bool inside)
+    {
+      for (auto i : leaf.data())
+        if (inside || volume.contains(vec_type{this->_points[i]}))
+          f(i);
+    });
+  }
+
+  /// Finds the points within \p radius of each of the \p n query
+  /// points in parallel (see NeighborTable).
+  void findNeighbors(const vec_type* points,
+    size_t n,
+    real radius,
+    Neighbors& neighbors,
+    bool withDistances = false,
+    int threadCount = 0) const
+  {
+    neighbors.build(n, [&](size_t i, auto f)
+    {
+      forEachNeighbor(points[i], radius, f);
+    }, withDistances, threadCount);
+  }
+
 protected:
   using BranchNode = typename Base::BranchNode;
   using LeafNode = typename Base::LeafNode;
@@ -201,16 +256,15 @@ protected:
     BranchNode* branch,
     const key_type& key) override;
 
+  template <typename F>
   void radiusSearch(const vec_type& point,
-    real radius,
+    real r2,
     const key_type& key,
     BranchNode* branch,
-    pid_list& list) const;
+    F& f) const;
 
-  real knnSearch(KNN& knn,
-    real r2,
-    const key_type& key,
-    BranchNode* branch) const;
+  template <typename K>
+  void knnSearch(K& knn) const;
 
 private:
   SplitTest _splitTest;
@@ -325,13 +379,6 @@ epsilon()
   return std::numeric_limits<real>::epsilon();
 }
 
-template <typename real>
-inline constexpr real
-inf()
-{
-  return std::numeric_limits<real>::max();
-}
-
 } // end namespace ptb
 
 template <int D, typename real, typename PA, typename IL>
@@ -343,17 +390,21 @@ PointTree<D, real, PA, IL>::findNeighbors(const vec_type& p,
   if (/*!this->bounds().contains(p) || */radius <= 0)
     return 0;
   list.clear();
-  radiusSearch(p, radius * radius, key_type{0LL}, this->root(), list);
+  forEachNeighbor(p, radius, [&list](point_id i, real)
+  {
+    list.add(i);
+  });
   return list.size();
 }
 
 template <int D, typename real, typename PA, typename IL>
+template <typename F>
 void
 PointTree<D, real, PA, IL>::radiusSearch(const vec_type& p,
   real r2,
   const key_type& key,
   BranchNode* branch,
-  pid_list& list) const
+  F& f) const
 {
   auto depth = branch->depth() + 1;
   auto s2 = ptb::searchSize2(this->nodeSize(depth).squaredNorm(), r2);
@@ -368,88 +419,111 @@ PointTree<D, real, PA, IL>::radiusSearch(const vec_type& p,
       if (ptb::epsilon<real>() + d2 > s2)
         continue;
       if (!child->isLeaf())
-        radiusSearch(p, r2, childKey, (BranchNode*)child, list);
+        radiusSearch(p, r2, childKey, (BranchNode*)child, f);
       else
         for (auto index : ((LeafNode*)child)->data())
-          if ((p - this->_points[index]).squaredNorm() <= r2)
-            list.add(index);
+          if (auto d2 = (p - this->_points[index]).squaredNorm(); d2 <= r2)
+            f(index, d2);
     }
 }
 
 template <int D, typename real, typename PA, typename IL>
+template <typename Norm>
 int
 PointTree<D, real, PA, IL>::findNearestNeighbors(const vec_type& p,
   int k,
   point_id indices[],
   real* distances,
-  typename KNN::Norm norm) const
+  Norm norm) const
 {
   /*
   if (!this->bounds().contains(p))
     return 0;
   */
 
-  KNN knn{p, k, norm};
+  KNNT<Norm> knn{p, k, norm};
   auto n = this->_points.size();
 
-  if (n <= k)
-    for (int i = 0; i < n; ++i)
+  // Nodes can only be pruned if the norm is monotone; otherwise, all
+  // points are tested
+  if (n <= k || !knn.isMonotoneNorm())
+    for (point_id i = 0; i < n; ++i)
       knn.test(this->_points[i], i);
   else
-    knnSearch(knn, ptb::inf<real>(), key_type{0LL}, this->root());
+    knnSearch(knn);
   return knn.results(indices, distances);
 }
 
 template <int D, typename real, typename PA, typename IL>
-real
-PointTree<D, real, PA, IL>::knnSearch(KNN& knn,
-  real r2,
-  const key_type& key,
-  BranchNode* branch) const
+template <typename K>
+void
+PointTree<D, real, PA, IL>::knnSearch(K& knn) const
 {
+  // Best-first search: nodes are visited in increasing order of the
+  // distance from their bounds to the sample, until that distance is
+  // not less than the distance to the current k-th neighbor. The
+  // distance to a node is the norm of the per-axis gaps from the
+  // sample to its bounds, a lower bound for monotone norms
   struct NodeEntry
   {
     TreeNodeBase<D>* node;
     key_type key;
+    real d2;
 
-    NodeEntry() = default;
-
-    NodeEntry(TreeNodeBase<D>* node, const key_type& key):
-      node{node}, key{key}
+    bool operator <(const NodeEntry& other) const
     {
-      // do nothing
+      return d2 > other.d2;
     }
 
   }; // NodeEntry
 
-  using Queue = typename KNN::template Queue<NodeEntry>;
   constexpr auto N = (int)ipow2<D>();
+  // The heap is reused by the searches of the calling thread
+  static thread_local std::vector<NodeEntry> heap;
+  const auto& p = knn.sample();
+  auto distance2 = [&p, &knn](const bounds_type& b)
+  {
+    vec_type g;
 
-  Queue nq{N};
-  auto depth = branch->depth() + 1;
-  auto n2 = this->nodeSize(depth).squaredNorm();
-
-  for (int i = 0; i < N; i++)
-    if (auto child = branch->child(i))
-    {
-      auto childKey = key_type(key).pushChild(i);
-      auto d2 = (knn.sample() - this->center(childKey, depth)).squaredNorm();
+    for (int i = 0; i < D; ++i)
+      g[i] = std::max({b[0][i] - p[i], p[i] - b[1][i], real(0)});
+    return knn.norm(g);
+  };
 
-      nq.insert(d2, NodeEntry{child, childKey});
-    }
-  for (auto n = nq.size(), i = 0;
-    i < n && ptb::epsilon<real>() + nq.key(i) <= ptb::searchSize2(n2, r2);
-    ++i)
+  heap.clear();
+  heap.push_back({this->root(), key_type{0LL}, 0});
+  while (!heap.empty())
   {
-    const auto& e = nq.value(i);
+    std::pop_heap(heap.begin(), heap.end());
+
+    auto e = heap.back();
 
-    if (!e.node->isLeaf())
-      r2 = knnSearch(knn, r2, e.key, (BranchNode*)e.node);
-    else
+    heap.pop_back();
+    if (e.d2 >= knn.maxSquaredDistance())
+      break;
+    if (e.node->isLeaf())
+    {
       for (auto index : ((LeafNode*)e.node)->data())
-        knn.test(this->_points[index], index, r2);
+        knn.test(this->_points[index], index);
+      continue;
+    }
+
+    auto branch = (BranchNode*)e.node;
+    auto depth = branch->depth() + 1;
+
+    for (int i = 0; i < N; ++i)
+      if (auto child = branch->child(i))
+      {
+        auto key = key_type(e.key).pushChild(i);
+        auto d2 = distance2(this->bounds(key, depth));
+
+        if (d2 < knn.maxSquaredDistance())
+        {
+          heap.push_back({child, key, d2});
+          std::push_heap(heap.begin(), heap.end());
+        }
+      }
   }
-  return r2;
 }
 
 } // namespace cg
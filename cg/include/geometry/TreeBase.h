@@ -28,7 +28,7 @@
 // Class definition for quadtree/octree base.
 //
 // Author: Paulo Pagliosa
-// Last revision: 12/09/2022
+// Last revision: 19/10/2026
 
 #ifndef __TreeBase_h
 #define __TreeBase_h
@@ -37,7 +37,7 @@
 #include "core/BlockAllocable.h"
 #include "core/ContentHolder.h"
 #include "core/SharedObject.h"
-#include "geometry/Bounds3.h"
+#include "geometry/ConvexVolume.h"
 #include <cassert>
 #include <set>
 
@@ -184,6 +184,10 @@ public:
 
 }; // TreeLeafNode
 
+template <int D, typename T>
+inline constexpr auto memoryCategoryOf<TreeLeafNode<D, T>> =
+  MemoryCategory::TreeNodes;
+
 
 /////////////////////////////////////////////////////////////////////
 //
@@ -206,6 +210,10 @@ public:
 
 }; // TreeBranchNode
 
+template <int D, typename T>
+inline constexpr auto memoryCategoryOf<TreeBranchNode<D, T>> =
+  MemoryCategory::TreeNodes;
+
 
 /////////////////////////////////////////////////////////////////////
 //
@@ -689,6 +697,27 @@ public:
     return leaf_iterator{(TreeLeafNode<D, LT>*)node, k};
   }
 
+  /// Calls f(leaf, inside) for each leaf whose bounds intersect
+  /// \p box, where inside is true if the leaf is inside \p box.
+  template <typename F>
+  void forEachLeaf(const bounds_type& box, F f) const
+  {
+    auto c = [&box](const bounds_type& b, int) { return classify(box, b); };
+    rangeSearch(c, 0, f);
+  }
+
+  /// Calls f(leaf, inside) for each leaf whose bounds intersect
+  /// \p volume, where inside is true if the leaf is inside \p volume.
+  template <typename F>
+  void forEachLeaf(const ConvexVolume<real, D>& volume, F f) const
+  {
+    auto c = [&volume](const bounds_type& b, auto& mask)
+    {
+      return volume.classify(b, mask);
+    };
+    rangeSearch(c, volume.planes(), f);
+  }
+
   const auto& bounds() const
   {
     return _bounds;
@@ -833,6 +862,24 @@ protected:
     return _resolution * real(this->sizeBits(this->_maxDepth - depth));
   }
 
+  // Visits the leafs whose bounds are not outside the range of a query
+  // given by the classifier c(bounds, state). A copy of the state of a
+  // node is passed to each of its children
+  template <typename C, typename S, typename F>
+  void rangeSearch(C& c, S state, F& f) const
+  {
+    if (auto r = c(_bounds, state); r == Containment::Inside)
+      visitLeafs(root(), key_type{0LL}, f);
+    else if (r == Containment::Intersect)
+      rangeSearch(root(), key_type{0LL}, c, state, f);
+  }
+
+  template <typename C, typename S, typename F>
+  void rangeSearch(BranchNode*, const key_type&, C&, S, F&) const;
+
+  template <typename F>
+  void visitLeafs(BranchNode*, const key_type&, F&) const;
+
 private:
   struct NodeIt
   {
@@ -965,6 +1012,58 @@ RegionTree<D, real, LT, BT>::makeEmptyLeafs(BranchNode* branch,
   }
 }
 
+template <int D, typename real, typename LT, typename BT>
+template <typename C, typename S, typename F>
+void
+RegionTree<D, real, LT, BT>::rangeSearch(BranchNode* branch,
+  const key_type& key,
+  C& c,
+  S state,
+  F& f) const
+{
+  constexpr auto N = (int)ipow2<D>();
+  auto depth = branch->depth() + 1;
+
+  for (int i = 0; i < N; ++i)
+    if (auto child = branch->child(i))
+    {
+      auto childKey = key.childKey(i);
+      auto childState = state;
+      auto r = c(bounds(childKey, depth), childState);
+
+      if (r == Containment::Outside)
+        continue;
+      if (child->isLeaf())
+        f(leaf_iterator{(LeafNode*)child, childKey},
+          r == Containment::Inside);
+      else if (r == Containment::Inside)
+        visitLeafs((BranchNode*)child, childKey, f);
+      else
+        rangeSearch((BranchNode*)child, childKey, c, childState, f);
+    }
+}
+
+template <int D, typename real, typename LT, typename BT>
+template <typename F>
+void
+RegionTree<D, real, LT, BT>::visitLeafs(BranchNode* branch,
+  const key_type& key,
+  F& f) const
+{
+  constexpr auto N = (int)ipow2<D>();
+
+  for (int i = 0; i < N; ++i)
+    if (auto child = branch->child(i))
+    {
+      auto childKey = key.childKey(i);
+
+      if (child->isLeaf())
+        f(leaf_iterator{(LeafNode*)child, childKey}, true);
+      else
+        visitLeafs((BranchNode*)child, childKey, f);
+    }
+}
+
 template <int D, typename real, typename LT, typename BT>
 typename RegionTree<D, real, LT, BT>::NodeIt
 RegionTree<D, real, LT, BT>::findNeighbor(const NodeIt& nit,
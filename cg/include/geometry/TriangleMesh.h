@@ -28,7 +28,7 @@
 // Class definition for simple triangle mesh.
 //
 // Author: Paulo Pagliosa
-// Last revision: 16/08/2022
+// Last revision: 19/10/2026
 
 #ifndef __TriangleMesh_h
 #define __TriangleMesh_h
@@ -116,6 +116,9 @@ public:
     return _data.uv != nullptr;
   }
 
+  /// Returns the size in bytes of the arrays of this mesh.
+  size_t memorySize() const;
+
   void print(const char* s, FILE* f = stdout) const;
 
 private:
@@ -0,0 +1,262 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2026 Paulo Pagliosa.                              |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: VerletList.h
+// ========
+// Class definition for Verlet neighbor list.
+//
+// Author: Paulo Pagliosa
+// Last revision: 19/10/2026
+
+#ifndef __VerletList_h
+#define __VerletList_h
+
+#include "geometry/CompactPointGrid.h"
+#include <memory>
+
+namespace cg
+{ // begin namespace cg
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// VerletListStats: Verlet list statistics
+// ===============
+struct VerletListStats
+{
+  uint64_t updates;
+  uint64_t rebuilds;
+  // Largest displacement seen by an update that checked the lists
+  double maxDisplacement;
+
+  /// Returns the fraction of updates that rebuilt the lists.
+  auto rebuildRate() const
+  {
+    return updates ? double(rebuilds) / double(updates) : 0.0;
+  }
+
+}; // VerletListStats
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// VerletList: Verlet neighbor list class
+// ==========
+//
+// Neighbor lists of the points of a point array, usually the
+// positions of a ParticleSystem, built with radius h + skin. The
+// lists remain valid until some point moves more than skin / 2 from
+// its position at the last build, so update() only rebuilds them
+// when this happens.
+//
+// A rebuild is a full rebuild: the lists of all points are recomputed,
+// in parallel, reusing the grid and the buffers of the previous one.
+// Rebuilding only the lists of the points that moved more than
+// skin / 2 (and of their neighbors) would require a reference position
+// per list and a relayout of the (CSR) neighbor table anyway, so it is
+// not done; the skin is what makes rebuilds infrequent.
+//
+template <int D, typename real, typename PA, typename ID = int>
+class VerletList: public PointHolder<D, real, PA>
+{
+public:
+  using PointSet = PointHolder<D, real, PA>;
+  using point_id = ID;
+  using vec_type = Vector<real, D>;
+  using Neighbors = NeighborTable<point_id, real>;
+
+  VerletList(const PA& points, real h, real skin, int threadCount = 0):
+    PointSet(points),
+    _threadCount{threadCount}
+  {
+    setRadius(h, skin);
+  }
+
+  auto radius() const
+  {
+    return _radius;
+  }
+
+  auto skin() const
+  {
+    return _skin;
+  }
+
+  /// Sets the interaction radius and the skin. The lists are rebuilt
+  /// by the next update.
+  void setRadius(real h, real skin)
+  {
+    if (h <= 0 || skin < 0)
+      throw std::logic_error("VerletList: bad radius");
+    _radius = h;
+    _skin = skin;
+    _grid.reset();
+    _valid = false;
+  }
+
+  /// Updates the lists from the current positions of the points.
+  /// Returns true if the lists were rebuilt.
+  bool update();
+
+  /// Rebuilds the lists of all points from their current positions.
+  void rebuild();
+
+  /// Returns the lists: the neighbors of point i within h + skin of
+  /// its position at the last build, excluding i.
+  const auto& neighbors() const
+  {
+    return _neighbors;
+  }
+
+  /// Calls f(j, d2) for each neighbor j of point i whose current
+  /// squared distance d2 to i is not greater than h squared.
+  template <typename F>
+  void forEachNeighbor(point_id i, F f) const;
+
+  const auto& stats() const
+  {
+    return _stats;
+  }
+
+  void resetStats()
+  {
+    _stats = {};
+  }
+
+private:
+  using Grid = CompactPointGrid<D, real, std::vector<vec_type>, ID>;
+
+  std::vector<vec_type> _positions;
+  std::unique_ptr<Grid> _grid;
+  Neighbors _neighbors;
+  std::vector<real> _displacements;
+  VerletListStats _stats{};
+  real _radius;
+  real _skin;
+  int _threadCount;
+  bool _valid{};
+
+  real maxDisplacement();
+
+}; // VerletList
+
+template <int D, typename real, typename PA, typename ID>
+real
+VerletList<D, real, PA, ID>::maxDisplacement()
+{
+  const auto n = size_t(this->_points.size());
+  const auto t = parallelThreads(n, _threadCount);
+
+  _displacements.assign(t, 0);
+  parallelFor(n, [this](size_t b, size_t e, int t)
+  {
+    real d2{0};
+
+    for (auto i = b; i < e; ++i)
+      d2 = std::max(d2, (vec_type{this->_points[i]} -
+        _positions[i]).squaredNorm());
+    _displacements[t] = d2;
+  }, t);
+  return sqrt(*std::max_element(_displacements.begin(),
+    _displacements.end()));
+}
+
+template <int D, typename real, typename PA, typename ID>
+bool
+VerletList<D, real, PA, ID>::update()
+{
+  ++_stats.updates;
+  if (_valid && _positions.size() == size_t(this->_points.size()))
+  {
+    auto d = maxDisplacement();
+
+    _stats.maxDisplacement = std::max(_stats.maxDisplacement, double(d));
+    if (2 * d <= _skin)
+      return false;
+  }
+  rebuild();
+  return true;
+}
+
+template <int D, typename real, typename PA, typename ID>
+void
+VerletList<D, real, PA, ID>::rebuild()
+{
+  const auto n = size_t(this->_points.size());
+
+  ++_stats.rebuilds;
+  _positions.resize(n);
+  _valid = true;
+  if (n == 0)
+  {
+    _neighbors.clear();
+    return;
+  }
+  parallelFor(n, [this](size_t b, size_t e, int)
+  {
+    for (auto i = b; i < e; ++i)
+      _positions[i] = vec_type{this->_points[i]};
+  }, _threadCount);
+
+  // The grid is recreated only when the points leave its bounds
+  const auto r = _radius + _skin;
+  auto bounds = PointSet::computeBounds(this->_points, false);
+
+  if (_grid == nullptr ||
+    !_grid->bounds().contains(bounds.min()) ||
+    !_grid->bounds().contains(bounds.max()))
+  {
+    bounds.inflate(bounds.min() - vec_type{r});
+    bounds.inflate(bounds.max() + vec_type{r});
+    _grid = std::make_unique<Grid>(bounds, _positions, r, true, _threadCount);
+  }
+  else
+    _grid->rebuild();
+  _neighbors.build(n, [this, r](size_t i, auto f)
+  {
+    _grid->forEachNeighbor(_positions[i], r, [i, &f](ID j, real d2)
+    {
+      if (j != ID(i))
+        f(j, d2);
+    });
+  }, false, _threadCount);
+}
+
+template <int D, typename real, typename PA, typename ID>
+template <typename F>
+void
+VerletList<D, real, PA, ID>::forEachNeighbor(point_id i, F f) const
+{
+  const vec_type p{this->_points[i]};
+  const auto r2 = _radius * _radius;
+
+  for (auto s = _neighbors.begin(i), e = _neighbors.end(i); s != e; ++s)
+    if (auto d2 = (p - vec_type{this->_points[*s]}).squaredNorm(); d2 <= r2)
+      f(*s, d2);
+}
+
+} // end namespace cg
+
+#endif // __VerletList_h
@@ -28,7 +28,7 @@
 // Class definition for assets.
 //
 // Author: Paulo Pagliosa
-// Last revision: 13/07/2022
+// Last revision: 19/10/2026
 
 #ifndef __Assets_h
 #define __Assets_h
@@ -56,7 +56,8 @@ using MaterialMapIterator = typename MaterialMap::const_iterator;
 class Assets
 {
 public:
-  static constexpr auto dflMaxMeshSize = 1ULL << 20;
+  /// Default size limit, in bytes, of the cached meshes.
+  static constexpr auto dflMaxMeshSize = 64ULL << 20;
 
   static void initialize(size_t = dflMaxMeshSize);
 
@@ -28,11 +28,12 @@
 // Class definition for generic image.
 //
 // Author: Paulo Pagliosa
-// Last revision: 29/06/2020
+// Last revision: 19/10/2026
 
 #ifndef __Image_h
 #define __Image_h
 
+#include "core/MemoryAccounting.h"
 #include "core/SharedObject.h"
 #include "graphics/Color.h"
 #include <stdexcept>
@@ -150,7 +151,7 @@ public:
   // Destructor.
   ~ImageBuffer()
   {
-    delete []_data;
+    release();
   }
 
   auto width() const
@@ -214,6 +215,20 @@ private:
   int _H{};
   Pixel* _data{};
 
+  auto memorySize() const
+  {
+    return size_t(_W) * _H * sizeof(Pixel);
+  }
+
+  void release()
+  {
+    if (_data != nullptr)
+    {
+      MemoryAccounting::free(MemoryCategory::Images, memorySize());
+      delete []_data;
+    }
+  }
+
   friend Image;
 
 }; // ImageBuffer
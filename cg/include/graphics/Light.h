@@ -28,7 +28,7 @@
 // Class definition for light.
 //
 // Author: Paulo Pagliosa
-// Last revision: 28/02/2022
+// Last revision: 19/10/2026
 
 #ifndef __Light_h
 #define __Light_h
@@ -145,6 +145,12 @@ public:
 
   void setSpotAngle(float value);
 
+  /// Returns true if the light incides only within its range.
+  bool isFinite() const
+  {
+    return _type != Type::Directional && !flags.isSet(Infinite);
+  }
+
   /// Returns the light color at a point.
   Color lightColor(float distance) const;
 
@@ -0,0 +1,178 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2026 Paulo Pagliosa.                              |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: LightBVH.h
+// ========
+// Class definition for light BVH.
+//
+// Author: Paulo Pagliosa
+// Last revision: 19/10/2026
+
+#ifndef __LightBVH_h
+#define __LightBVH_h
+
+#include "core/SharedObject.h"
+#include "geometry/Bounds3.h"
+#include "graphics/Light.h"
+#include <cinttypes>
+#include <vector>
+
+namespace cg
+{ // begin namespace cg
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// LightBVH: light BVH class
+// ========
+//
+// Bounding volume hierarchy over the influence volumes of a set of
+// lights. The influence volume of a finite light is the sphere of
+// radius range() centered at its position. Directional lights and
+// lights with infinite range incide everywhere; they are kept apart
+// and visited by every query.
+//
+class LightBVH final: public SharedObject
+{
+public:
+  using LightArray = std::vector<Reference<Light>>;
+
+  LightBVH(LightArray&&, uint32_t maxLightsPerNode = 4);
+
+  auto size() const
+  {
+    return _nodes.size();
+  }
+
+  auto lightCount() const
+  {
+    return _lights.size();
+  }
+
+  auto& lights() const
+  {
+    return _lights;
+  }
+
+  Bounds3f bounds() const;
+
+  /// Invokes f(light) for every light that can incide at the point P.
+  template <typename F> void iterate(const vec3f& P, F f) const;
+
+  /**
+   *  Invokes f(i) for the index i into lights() of every light that
+   *  can incide at the point P. The indices are visited in increasing
+   *  order.
+   */
+  template <typename F> void iterateIndices(const vec3f& P, F f) const;
+
+private:
+  struct Sphere
+  {
+    vec3f center;
+    float squaredRadius;
+
+  }; // Sphere
+
+  struct Node
+  {
+    Bounds3f bounds;
+    // Index of the first light of a leaf, or of the second child of
+    // a branch (the first child of a branch is the next node)
+    uint32_t offset;
+    uint32_t count;
+
+    bool isLeaf() const
+    {
+      return count > 0;
+    }
+
+  }; // Node
+
+  using IndexArray = std::vector<uint32_t>;
+
+  static constexpr auto maxDepth = 64;
+
+  // Unbounded lights first, followed by the bounded lights in leaf order
+  LightArray _lights;
+  std::vector<Sphere> _spheres;
+  std::vector<Node> _nodes;
+  uint32_t _unboundedCount{};
+  uint32_t _maxLightsPerNode;
+
+  uint32_t makeNode(const LightArray&,
+    IndexArray&,
+    uint32_t,
+    uint32_t,
+    uint32_t);
+
+}; // LightBVH
+
+template <typename F>
+inline void
+LightBVH::iterate(const vec3f& P, F f) const
+{
+  iterateIndices(P, [this, &f](uint32_t i) { f(*_lights[i]); });
+}
+
+template <typename F>
+void
+LightBVH::iterateIndices(const vec3f& P, F f) const
+{
+  for (uint32_t i = 0; i < _unboundedCount; ++i)
+    f(i);
+  if (_nodes.empty())
+    return;
+
+  uint32_t stack[maxDepth];
+  int top = 0;
+
+  stack[top++] = 0;
+  while (top > 0)
+  {
+    auto i = stack[--top];
+    const auto& node = _nodes[i];
+
+    if (!node.bounds.contains(P))
+      continue;
+    if (node.isLeaf())
+    {
+      for (auto l = node.offset, e = l + node.count; l < e; ++l)
+      {
+        const auto& s = _spheres[l - _unboundedCount];
+
+        if ((P - s.center).squaredNorm() <= s.squaredRadius)
+          f(l);
+      }
+      continue;
+    }
+    stack[top++] = node.offset;
+    stack[top++] = i + 1;
+  }
+}
+
+} // end namespace cg
+
+#endif // __LightBVH_h
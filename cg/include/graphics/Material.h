@@ -28,7 +28,7 @@
 // Class definition for material.
 //
 // Author: Paulo Pagliosa
-// Last revision: 11/03/2022
+// Last revision: 19/10/2026
 
 #ifndef __Material_h
 #define __Material_h
@@ -60,6 +60,8 @@ public:
     diffuse{0.8f * color},
     shine{100}
   {
+    // Materials can be shared by several rendering threads
+    useAtomicReferenceCount();
     spot = specular = Color::white;
   }
 
@@ -28,9 +28,12 @@
 // Source file for block allocator.
 //
 // Author: Paulo Pagliosa
-// Last revision: 01/98/2019
+// Last revision: 19/10/2026
 
 #include "core/BlockAllocator.h"
+#include <cassert>
+#include <cstring>
+#include <functional>
 #include <iostream>
 
 namespace cg
@@ -43,38 +46,60 @@ namespace cg
 //
 // BlockStorage implementation
 // ============
-inline void
-BlockStorage::Block::insert(Block*& front, Block* block)
+inline size_t
+BlockStorage::blockMemorySize() const
 {
-  if (front == nullptr || front > block)
-  {
-    block->_next = front;
-    front = block;
-    return;
-  }
-
-  Block* b = front;
-
-  while (b->_next != nullptr && b->_next < block)
-    b = b->_next;
-  block->_next = b->_next;
-  b->_next = block;
+  return sizeof(Block) + _blockSize + bitmapSize() * sizeof(uint32_t);
 }
 
 BlockStorage::Block*
 BlockStorage::allocateBlock()
 {
-  auto block = new(_blockSize) Block;
+  auto bitmapBytes = bitmapSize() * sizeof(uint32_t);
+  auto block = new(_blockSize + bitmapBytes) Block;
 
   if (block == nullptr)
     return nullptr;
-  Block::insert(_headBlock, block);
+  memset(block->bitmap(_blockSize), 0, bitmapBytes);
+  MemoryAccounting::allocate(_category, blockMemorySize());
+  _blocks.insert(std::upper_bound(_blocks.begin(),
+    _blocks.end(),
+    block,
+    std::less<Block*>{}), block);
 #if _DEBUG && _DEBUG_BLOCKS > 0
-    std::cout << typeName << " BLOCK " << _blockCount << " ALLOCATED\n";
+    std::cout << typeName << " BLOCK " << _blocks.size() << " ALLOCATED\n";
 #endif
-    ++_blockCount;
-  _nextChunk = 0;
-  return _lastBlock = block;
+  return block;
+}
+
+inline bool
+BlockStorage::contains(const Block* b, void* ptr) const
+{
+  std::less_equal<const void*> le;
+  return le(b->chunks(), ptr) && !le(b->chunks() + _blockSize, ptr);
+}
+
+inline unsigned
+BlockStorage::chunkIndex(const Block* b, void* ptr) const
+{
+  // Blocks are small enough for a (faster) 32-bit division
+  return uint32_t((char*)ptr - b->chunks()) / uint32_t(_chunkSize);
+}
+
+inline BlockStorage::Block*
+BlockStorage::findBlock(void* ptr) const
+{
+  // Most chunks are freed shortly after being allocated
+  if (_currentBlock != nullptr && contains(_currentBlock, ptr))
+    return _currentBlock;
+
+  auto b = std::upper_bound(_blocks.begin(),
+    _blocks.end(),
+    ptr,
+    [](void* p, Block* b) { return std::less<void*>{}(p, b); });
+
+  assert(b != _blocks.begin() && contains(b[-1], ptr));
+  return *--b;
 }
 
 BlockStorage::~BlockStorage()
@@ -83,10 +108,10 @@ BlockStorage::~BlockStorage()
   size_t i = 0;
 #endif
 
-  while (auto temp = _headBlock)
+  for (auto block : _blocks)
   {
-    _headBlock = temp->_next;
-    delete temp;
+    MemoryAccounting::free(_category, blockMemorySize());
+    delete block;
 #if _DEBUG && _DEBUG_BLOCKS > 0
     std::cout << typeName << " BLOCK " << i++ << " FREED\n";
 #endif
@@ -96,70 +121,126 @@ BlockStorage::~BlockStorage()
 void*
 BlockStorage::allocate()
 {
-  if (_freeList != nullptr)
-  {
-    void* ptr = _freeList;
+  auto b = _currentBlock;
 
-    _freeList = nextOf(ptr);
-    return ptr;
+  if (b == nullptr || b->used == _maxSize)
+  {
+    if (_partialBlocks.empty())
+    {
+      if ((b = allocateBlock()) == nullptr)
+        return nullptr;
+    }
+    else
+    {
+      b = _partialBlocks.back();
+      _partialBlocks.pop_back();
+    }
+    _currentBlock = b;
   }
-  if (_chunkSize > _blockSize - _nextChunk)
-    if (allocateBlock() == nullptr)
-      return nullptr;
 
-  void* ptr = ((char*)(_lastBlock + 1)) + _nextChunk;
+  void* ptr = b->freeList;
+
+  unsigned i;
+
+  if (ptr == nullptr)
+    ptr = b->chunks() + (i = b->next++) * _chunkSize;
+  else
+  {
+    b->freeList = nextOf(ptr);
+    i = chunkIndex(b, ptr);
+  }
 
-  _nextChunk += _chunkSize;
+  b->bitmap(_blockSize)[i >> 5] |= 1u << (i & 31);
+  ++b->used;
+  ++_chunkCount;
   return ptr;
 }
 
 void
-BlockStorage::sort(void*& head)
+BlockStorage::free(void* ptr)
 {
-  void* a{head};
-  void* b;
-
-  if (a == nullptr || (b = nextOf(a)) == nullptr)
-    return;
-  {
-    void* s{a};
-    void* f{b};
-
-    while (f != nullptr)
-      if ((f = nextOf(f)) != nullptr)
-      {
-        s = nextOf(s);
-        f = nextOf(f);
-      }
-    b = nextOf(s);
-    nextOf(s) = nullptr;
-  }
-  sort(a);
-  sort(b);
-  head = merge(a, b);
+  free(findBlock(ptr), ptr);
 }
 
-void*
-BlockStorage::merge(void* a, void* b)
+void
+BlockStorage::free(Block* b, void* ptr)
 {
-  if (a == nullptr)
-    return b;
-  if (b == nullptr)
-    return a;
+  auto i = chunkIndex(b, ptr);
+  auto& bits = b->bitmap(_blockSize)[i >> 5];
+  auto mask = 1u << (i & 31);
+
+  assert(bits & mask);
+  bits &= ~mask;
+  nextOf(ptr) = b->freeList;
+  b->freeList = ptr;
+  --_chunkCount;
+  // Blocks other than the current one are only left when full
+  if (b->used-- == _maxSize && b != _currentBlock)
+    _partialBlocks.push_back(b);
+}
 
-  void* r;
+unsigned
+BlockStorage::allocate(void*& list, unsigned n)
+{
+  unsigned count = 0;
 
-  if (a <= b)
+  for (; count < n; ++count)
   {
-    r = a;
-    nextOf(r) = merge(nextOf(a), b);
+    auto ptr = allocate();
+
+    if (ptr == nullptr)
+      break;
+    nextOf(ptr) = list;
+    list = ptr;
   }
-  else
+  return count;
+}
+
+void
+BlockStorage::free(void* head, void* tail)
+{
+  // Chunks of a list are likely to belong to the same block
+  for (Block* b{};;)
   {
-    r = b;
-    nextOf(r) = merge(a, nextOf(b));
+    auto next = nextOf(head);
+
+    if (b == nullptr || !contains(b, head))
+      b = findBlock(head);
+    free(b, head);
+    if (head == tail)
+      break;
+    head = next;
   }
-  return r;
+}
+
+int
+BlockStorage::trim()
+{
+  auto isFree = [](Block* b) { return b->used == 0; };
+
+  _partialBlocks.erase(std::remove_if(_partialBlocks.begin(),
+    _partialBlocks.end(),
+    isFree), _partialBlocks.end());
+  if (_currentBlock != nullptr && isFree(_currentBlock))
+    _currentBlock = nullptr;
+
+  auto n = _blocks.size();
+
+  _blocks.erase(std::remove_if(_blocks.begin(),
+    _blocks.end(),
+    [this, isFree](Block* b)
+    {
+      if (!isFree(b))
+        return false;
+      MemoryAccounting::free(_category, blockMemorySize());
+      delete b;
+      return true;
+    }), _blocks.end());
+  n -= _blocks.size();
+#if _DEBUG && _DEBUG_BLOCKS > 0
+  std::cout << typeName << ' ' << n << " BLOCK(S) TRIMMED\n";
+#endif
+  return (int)n;
 }
 
 } // end namespace cg
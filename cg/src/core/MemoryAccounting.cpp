@@ -0,0 +1,130 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2026 Paulo Pagliosa.                              |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: MemoryAccounting.cpp
+// ========
+// Source file for memory accounting registry.
+//
+// Author: Paulo Pagliosa
+// Last revision: 19/10/2026
+
+#include "core/MemoryAccounting.h"
+#include <cstdio>
+#include <iterator>
+
+namespace cg
+{ // begin namespace cg
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// MemoryAccounting implementation
+// ================
+MemoryCounters
+MemoryAccounting::counters(MemoryCategory c)
+{
+  const auto& s = _slots[size_t(c)];
+
+  return
+  {
+    s.liveBytes.load(relaxed),
+    s.peakBytes.load(relaxed),
+    s.allocations.load(relaxed),
+    s.frees.load(relaxed)
+  };
+}
+
+MemoryCounters
+MemoryAccounting::total()
+{
+  // The total peak is the sum of the peaks, an upper bound of the
+  // actual peak of the sum
+  MemoryCounters t{};
+
+  for (size_t i = 0; i < memoryCategoryCount; ++i)
+  {
+    auto c = counters(MemoryCategory(i));
+
+    t.liveBytes += c.liveBytes;
+    t.peakBytes += c.peakBytes;
+    t.allocations += c.allocations;
+    t.frees += c.frees;
+  }
+  return t;
+}
+
+void
+MemoryAccounting::resetPeaks()
+{
+  for (auto& s : _slots)
+    s.peakBytes.store(s.liveBytes.load(relaxed), relaxed);
+}
+
+const char*
+MemoryAccounting::name(MemoryCategory c)
+{
+  static const char* names[]
+  {
+    "meshes",
+    "bvh",
+    "treeNodes",
+    "indexLists",
+    "images",
+    "visDatasets",
+    "other"
+  };
+  static_assert(std::size(names) == memoryCategoryCount);
+  return names[size_t(c)];
+}
+
+std::string
+MemoryAccounting::toJSON()
+{
+  auto json = [](const char* name, const MemoryCounters& c)
+  {
+    char buffer[256];
+
+    snprintf(buffer, sizeof buffer,
+      "\"%s\":{\"liveBytes\":%llu,\"peakBytes\":%llu,"
+      "\"allocations\":%llu,\"frees\":%llu}",
+      name,
+      (unsigned long long)c.liveBytes,
+      (unsigned long long)c.peakBytes,
+      (unsigned long long)c.allocations,
+      (unsigned long long)c.frees);
+    return std::string{buffer};
+  };
+  std::string s{"{"};
+
+  for (size_t i = 0; i < memoryCategoryCount; ++i)
+  {
+    auto c = MemoryCategory(i);
+
+    s += json(name(c), counters(c)) + ',';
+  }
+  return s + json("total", total()) + '}';
+}
+
+} // end namespace cg
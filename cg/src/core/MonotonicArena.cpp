@@ -0,0 +1,149 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2026 Paulo Pagliosa.                              |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: MonotonicArena.cpp
+// ========
+// Source file for monotonic arena allocator.
+//
+// Author: Paulo Pagliosa
+// Last revision: 19/10/2026
+
+#include "core/MonotonicArena.h"
+#include <algorithm>
+
+namespace cg
+{ // begin namespace cg
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// MonotonicArena implementation
+// ==============
+struct alignas(std::max_align_t) MonotonicArena::Chunk
+{
+  Chunk* next;
+  size_t size;
+
+  auto data()
+  {
+    return (char*)(this + 1);
+  }
+
+}; // MonotonicArena::Chunk
+
+MonotonicArena::Chunk*
+MonotonicArena::insertChunk(size_t size)
+{
+  // Insert the new chunk after the current one
+  auto& next = _chunk != nullptr ? _chunk->next : _head;
+  auto chunk = (Chunk*)::operator new(sizeof(Chunk) + size);
+
+  chunk->next = next;
+  chunk->size = size;
+  next = chunk;
+  ++_chunkCount;
+  ++_mallocCount;
+  _capacity += size;
+  return chunk;
+}
+
+void*
+MonotonicArena::allocateChunk(size_t size, size_t alignment)
+{
+  // Bytes needed in the worst case of alignment (chunk data are
+  // aligned to alignof(Chunk))
+  auto needed = alignment <= alignof(Chunk) ? size : size + alignment - 1;
+  // Try to reuse the chunk following the current one
+  auto c = _chunk != nullptr ? _chunk->next : _head;
+
+  if (c == nullptr || c->size < needed)
+    c = insertChunk(std::max(_chunkSize, needed));
+  _chunk = c;
+  _top = c->data();
+  _end = _top + c->size;
+  return allocate(size, alignment);
+}
+
+void
+MonotonicArena::reserve(size_t size)
+{
+  if (size_t(_end - _top) >= size)
+    return;
+
+  auto c = _chunk != nullptr ? _chunk->next : _head;
+
+  if (c == nullptr || c->size < size)
+    insertChunk(size);
+}
+
+inline void
+MonotonicArena::freeChunk(Chunk* c)
+{
+  --_chunkCount;
+  _capacity -= c->size;
+  ::operator delete(c);
+}
+
+void
+MonotonicArena::rewind(const Marker& m)
+{
+  auto c = (Chunk*)m.chunk;
+
+  // Release the oversized chunks after the mark
+  for (auto p = c != nullptr ? &c->next : &_head; *p != nullptr;)
+    if ((*p)->size <= _chunkSize)
+      p = &(*p)->next;
+    else
+    {
+      auto temp = *p;
+
+      *p = temp->next;
+      freeChunk(temp);
+    }
+  _chunk = c;
+  _top = m.top;
+  _end = c != nullptr ? c->data() + c->size : nullptr;
+}
+
+void
+MonotonicArena::release()
+{
+  while (auto temp = _head)
+  {
+    _head = temp->next;
+    freeChunk(temp);
+  }
+  _chunk = nullptr;
+  _top = _end = nullptr;
+}
+
+MonotonicArena&
+MonotonicArena::frame()
+{
+  thread_local MonotonicArena arena;
+  return arena;
+}
+
+} // end namespace cg
@@ -28,11 +28,11 @@
 // Source file for BVH.
 //
 // Author: Paulo Pagliosa
-// Last revision: 21/01/2022
+// Last revision: 19/10/2026
 
 #include "geometry/BVH.h"
 #include <algorithm>
-#include <stack>
+#include <new>
 
 namespace cg
 { // begin namespace cg
@@ -65,12 +65,6 @@ struct BVHBase::Node
   uint32_t first;
   uint32_t count;
 
-  ~Node()
-  {
-    delete children[0];
-    delete children[1];
-  }
-
   Node(const Bounds3f& bounds, uint32_t first, uint32_t count):
     bounds{bounds},
     first{first},
@@ -122,6 +116,7 @@ struct BVHBase::Node
   }
 
   static void iterate(const Node*, BVHNodeFunction);
+  static uint32_t depth(const Node*);
 
 }; // BVHBase::Node
 
@@ -141,6 +136,23 @@ BVHBase::Node::iterate(const Node* node, BVHNodeFunction f)
   }
 }
 
+uint32_t
+BVHBase::Node::depth(const Node* node)
+{
+  if (node->isLeaf())
+    return 0;
+  return 1 + std::max(depth(node->children[0]), depth(node->children[1]));
+}
+
+template <typename... Args>
+inline BVHBase::Node*
+BVHBase::newNode(Args&&... args)
+{
+  // Nodes are freed all at once, with the BVH
+  static_assert(std::is_trivially_destructible_v<Node>);
+  return new (_nodes.allocate<Node>(1)) Node{std::forward<Args>(args)...};
+}
+
 inline BVHBase::Node*
 BVHBase::makeLeaf(PrimitiveInfoArray& primitiveInfo,
   uint32_t start,
@@ -155,7 +167,7 @@ BVHBase::makeLeaf(PrimitiveInfoArray& primitiveInfo,
     bounds.inflate(primitiveInfo[i].bounds);
     orderedPrimitiveIds.push_back(_primitiveIds[primitiveInfo[i].index]);
   }
-  return new Node{bounds, first, end - start};
+  return newNode(bounds, first, end - start);
 }
 
 inline auto
@@ -195,37 +207,67 @@ BVHBase::makeNode(PrimitiveInfoArray& primitiveInfo,
     {
       return a.centroid[dim] < b.centroid[dim];
     });
-  return new Node{makeNode(primitiveInfo, start, mid, orderedPrimitiveIds),
-    makeNode(primitiveInfo, mid, end, orderedPrimitiveIds)};
+  auto c0 = makeNode(primitiveInfo, start, mid, orderedPrimitiveIds);
+  auto c1 = makeNode(primitiveInfo, mid, end, orderedPrimitiveIds);
+
+  return newNode(c0, c1);
+}
+
+void
+BVHBase::build(PrimitiveInfoArray& primitiveInfo)
+{
+  auto np = (uint32_t)primitiveInfo.size();
+  IndexArray orderedPrimitiveIds;
+
+  orderedPrimitiveIds.reserve(np);
+  // A BVH has at most 2 * np - 1 nodes: take them from a single chunk
+  // of that size rather than from a default sized one
+  _nodes.reserve((2 * size_t(std::max(np, 1u)) - 1) * sizeof(Node));
+  _root = makeNode(primitiveInfo, 0, np, orderedPrimitiveIds);
+  _depth = Node::depth(_root);
+  _primitiveIds.swap(orderedPrimitiveIds);
+  _memorySize = _nodes.capacity() + np * sizeof(uint32_t);
+  MemoryAccounting::allocate(MemoryCategory::BVH, _memorySize);
 }
 
 BVHBase::~BVHBase()
 {
-  delete _root;
+  // Nodes are freed with _nodes
+  if (_memorySize != 0)
+    MemoryAccounting::free(MemoryCategory::BVH, _memorySize);
 }
 
 bool
 BVHBase::intersect(const Ray3f& ray) const
 {
   NodeRay r{ray};
-  std::stack<Node*> stack;
-
-  stack.push(_root);
-  while (!stack.empty())
+  // Traversal stack, whose size never exceeds the depth plus one
+  ArenaScope scope;
+  auto stack = scope.arena().allocate<Node*>(_depth + 1);
+  int top{};
+  uint64_t visits{};
+  auto hit = false;
+
+  stack[top++] = _root;
+  while (top > 0)
   {
-    auto node = stack.top();
+    auto node = stack[--top];
 
-    stack.pop();
+    ++visits;
     if (node->intersect(ray))
       if (!node->isLeaf())
       {
-        stack.push(node->children[0]);
-        stack.push(node->children[1]);
+        stack[top++] = node->children[0];
+        stack[top++] = node->children[1];
       }
       else if (intersectLeaf(node->first, node->count, ray))
-        return true;
+      {
+        hit = true;
+        break;
+      }
   }
-  return false;
+  bvhStats().nodeVisits += visits;
+  return hit;
 }
 
 bool
@@ -235,23 +277,28 @@ BVHBase::intersect(const Ray3f& ray, Intersection& hit) const
   hit.distance = ray.tMax;
 
   NodeRay r{ray};
-  std::stack<Node*> stack;
-
-  stack.push(_root);
-  while (!stack.empty())
+  // Traversal stack, whose size never exceeds the depth plus one
+  ArenaScope scope;
+  auto stack = scope.arena().allocate<Node*>(_depth + 1);
+  int top{};
+  uint64_t visits{};
+
+  stack[top++] = _root;
+  while (top > 0)
   {
-    auto node = stack.top();
+    auto node = stack[--top];
 
-    stack.pop();
+    ++visits;
     if (node->intersect(ray))
       if (node->isLeaf())
         intersectLeaf(node->first, node->count, ray, hit);
       else
       {
-        stack.push(node->children[0]);
-        stack.push(node->children[1]);
+        stack[top++] = node->children[0];
+        stack[top++] = node->children[1];
       }
   }
+  bvhStats().nodeVisits += visits;
   return hit.object != nullptr;
 }
 
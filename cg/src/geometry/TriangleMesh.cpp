@@ -28,9 +28,11 @@
 // Source file for simple triangle mesh.
 //
 // Author: Paulo Pagliosa
-// Last revision: 16/08/2022
+// Last revision: 19/10/2026
 
 #include "geometry/MeshSweeper.h"
+#include "core/MemoryAccounting.h"
+#include <atomic>
 #include <memory>
 
 namespace cg
@@ -41,23 +43,54 @@ namespace cg
 //
 // TriangleMesh implementation
 // ============
-static uint32_t nextMeshId;
+static std::atomic<uint32_t> nextMeshId;
+
+// Accounts the memory of each array of the mesh data d
+template <typename Op>
+static inline void
+accountArrays(const TriangleMesh::Data& d, Op op)
+{
+  auto nv = size_t(d.vertexCount);
+  auto nt = size_t(d.triangleCount);
+
+  if (d.vertices != nullptr)
+    op(MemoryCategory::Meshes, nv * sizeof(vec3f));
+  if (d.vertexNormals != nullptr)
+    op(MemoryCategory::Meshes, nv * sizeof(vec3f));
+  if (d.uv != nullptr)
+    op(MemoryCategory::Meshes, nv * sizeof(vec2f));
+  if (d.triangles != nullptr)
+    op(MemoryCategory::Meshes, nt * sizeof(TriangleMesh::Triangle));
+}
 
 TriangleMesh::TriangleMesh(Data&& data):
   id{++nextMeshId},
   _data{data}
 {
   memset(&data, 0, sizeof(Data));
+  // Meshes can be loaded and shared by several threads
+  useAtomicReferenceCount();
+  accountArrays(_data, MemoryAccounting::allocate);
 }
 
 TriangleMesh::~TriangleMesh()
 {
+  accountArrays(_data, MemoryAccounting::free);
   delete []_data.vertices;
   delete []_data.vertexNormals;
   delete []_data.uv;
   delete []_data.triangles;
 }
 
+size_t
+TriangleMesh::memorySize() const
+{
+  size_t size{};
+
+  accountArrays(_data, [&](MemoryCategory, size_t s) { size += s; });
+  return size;
+}
+
 const Bounds3f&
 TriangleMesh::bounds() const
 {
@@ -73,7 +106,10 @@ TriangleMesh::computeNormals()
   auto nv = _data.vertexCount;
 
   if (_data.vertexNormals == nullptr)
+  {
     _data.vertexNormals = new vec3f[nv];
+    MemoryAccounting::allocate(MemoryCategory::Meshes, nv * sizeof(vec3f));
+  }
 
   auto t = _data.triangles;
 
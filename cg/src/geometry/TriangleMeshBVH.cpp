@@ -28,7 +28,7 @@
 // Source file for triangle mesh BVH.
 //
 // Author: Paulo Pagliosa
-// Last revision: 07/02/2022
+// Last revision: 19/10/2026
 
 #include "geometry/TriangleMeshBVH.h"
 
@@ -50,6 +50,7 @@ TriangleMeshBVH::TriangleMeshBVH(const TriangleMesh& mesh, uint32_t maxt):
   assert(nt > 0);
   _primitiveIds.resize(nt);
 
+  ArenaScope scope;
   PrimitiveInfoArray primitiveInfo(nt);
 
   for (uint32_t i = 0; i < nt; ++i)
@@ -92,6 +93,7 @@ TriangleMeshBVH::intersectLeaf(uint32_t first,
   const Ray3f& ray) const
 {
   const auto& m = _mesh->data();
+  auto& stats = bvhStats();
 
   for (auto i = first, e = i + count; i < e; ++i)
   {
@@ -103,6 +105,7 @@ TriangleMeshBVH::intersectLeaf(uint32_t first,
     vec3f b;
     float t;
 
+    ++stats.triangleTests;
     if (triangle::intersect(ray, p0, p1, p2, b, t))
       return true;
   }
@@ -118,6 +121,7 @@ TriangleMeshBVH::intersectLeaf(uint32_t first,
   const auto& m = _mesh->data();
   auto hitCount = 0;
 
+  bvhStats().triangleTests += count;
   for (auto i = first, e = i + count; i < e; ++i)
   {
     auto tid = _primitiveIds[i];
@@ -28,7 +28,7 @@
 // Source file for assets.
 //
 // Author: Paulo Pagliosa
-// Last revision: 03/02/2022
+// Last revision: 19/10/2026
 
 #include "graphics/Application.h"
 #include "graphics/Assets.h"
@@ -50,10 +50,11 @@ MaterialMap Assets::_materials;
 size_t Assets::_maxMeshSize;
 size_t Assets::_meshSize;
 
+// Size in bytes of a mesh, as reported to MemoryAccounting
 static inline auto
 meshSize(const TriangleMesh* m)
 {
-  return m->data().vertexCount;
+  return m->memorySize();
 }
 
 static inline auto
@@ -28,7 +28,7 @@
 // Source file for generic image.
 //
 // Author: Paulo Pagliosa
-// Last revision: 10/02/2022
+// Last revision: 19/10/2026
 
 #include "graphics/Image.h"
 #include <algorithm>
@@ -58,6 +58,7 @@ ImageBuffer::ImageBuffer(int w, int h)
   _W = w;
   _H = h;
   _data = new Pixel[(size_t)w * h];
+  MemoryAccounting::allocate(MemoryCategory::Images, memorySize());
 }
 
 ImageBuffer::ImageBuffer(ImageBuffer&& other) noexcept:
@@ -72,7 +73,7 @@ ImageBuffer::ImageBuffer(ImageBuffer&& other) noexcept:
 ImageBuffer&
 ImageBuffer::operator =(ImageBuffer&& other) noexcept
 {
-  delete[]_data;
+  release();
   _W = other._W;
   _H = other._H;
   _data = other._data;
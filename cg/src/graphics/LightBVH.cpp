@@ -0,0 +1,141 @@
+//[]---------------------------------------------------------------[]
+//|                                                                 |
+//| Copyright (C) 2026 Paulo Pagliosa.                              |
+//|                                                                 |
+//| This software is provided 'as-is', without any express or       |
+//| implied warranty. In no event will the authors be held liable   |
+//| for any damages arising from the use of this software.          |
+//|                                                                 |
+//| Permission is granted to anyone to use this software for any    |
+//| purpose, including commercial applications, and to alter it and |
+//| redistribute it freely, subject to the following restrictions:  |
+//|                                                                 |
+//| 1. The origin of this software must not be misrepresented; you  |
+//| must not claim that you wrote the original software. If you use |
+//| this software in a product, an acknowledgment in the product    |
+//| documentation would be appreciated but is not required.         |
+//|                                                                 |
+//| 2. Altered source versions must be plainly marked as such, and  |
+//| must not be misrepresented as being the original software.      |
+//|                                                                 |
+//| 3. This notice may not be removed or altered from any source    |
+//| distribution.                                                   |
+//|                                                                 |
+//[]---------------------------------------------------------------[]
+//
+// OVERVIEW: LightBVH.cpp
+// ========
+// Source file for light BVH.
+//
+// Author: Paulo Pagliosa
+// Last revision: 19/10/2026
+
+#include "graphics/LightBVH.h"
+#include <algorithm>
+
+namespace cg
+{ // begin namespace cg
+
+
+/////////////////////////////////////////////////////////////////////
+//
+// LightBVH implementation
+// ========
+LightBVH::LightBVH(LightArray&& lights, uint32_t maxLightsPerNode):
+  _maxLightsPerNode{math::max(maxLightsPerNode, 1u)}
+{
+  LightArray unbounded;
+  IndexArray ids;
+
+  ids.reserve(lights.size());
+  for (uint32_t i = 0, n = (uint32_t)lights.size(); i < n; ++i)
+    if (lights[i]->isFinite())
+      ids.push_back(i);
+    else
+      unbounded.push_back(lights[i]);
+  _unboundedCount = (uint32_t)unbounded.size();
+  _lights.swap(unbounded);
+  _lights.reserve(lights.size());
+  _spheres.reserve(ids.size());
+  if (ids.empty())
+    return;
+  // Leaves append their lights to _lights in depth-first order
+  _nodes.reserve(2 * ids.size() / _maxLightsPerNode + 1);
+  makeNode(lights, ids, 0, (uint32_t)ids.size(), 0);
+}
+
+inline auto
+influenceBounds(const Light& light)
+{
+  auto r = vec3f{light.range()};
+  const auto& p = light.position();
+
+  return Bounds3f{p - r, p + r};
+}
+
+uint32_t
+LightBVH::makeNode(const LightArray& lights,
+  IndexArray& ids,
+  uint32_t start,
+  uint32_t end,
+  uint32_t depth)
+{
+  auto index = (uint32_t)_nodes.size();
+  Bounds3f bounds;
+  Bounds3f centroidBounds;
+
+  _nodes.emplace_back();
+  for (auto i = start; i < end; ++i)
+  {
+    const auto& light = *lights[ids[i]];
+
+    bounds.inflate(influenceBounds(light));
+    centroidBounds.inflate(light.position());
+  }
+  _nodes[index].bounds = bounds;
+
+  auto s = centroidBounds.size();
+  auto dim = s.x > s.y && s.x > s.z ? 0 : (s.y > s.z ? 1 : 2);
+
+  if (end - start <= _maxLightsPerNode || depth + 2 >= maxDepth ||
+    centroidBounds.max()[dim] == centroidBounds.min()[dim])
+  {
+    _nodes[index].offset = (uint32_t)_lights.size();
+    _nodes[index].count = end - start;
+    for (auto i = start; i < end; ++i)
+    {
+      const auto& light = lights[ids[i]];
+      auto r = light->range();
+
+      _lights.push_back(light);
+      _spheres.push_back({light->position(), r * r});
+    }
+    return index;
+  }
+
+  // Partition lights into two sets and build children
+  auto mid = (start + end) / 2;
+
+  std::nth_element(ids.begin() + start,
+    ids.begin() + mid,
+    ids.begin() + end,
+    [&lights, dim](uint32_t a, uint32_t b)
+    {
+      return lights[a]->position()[dim] < lights[b]->position()[dim];
+    });
+  makeNode(lights, ids, start, mid, depth + 1);
+
+  auto second = makeNode(lights, ids, mid, end, depth + 1);
+
+  _nodes[index].offset = second;
+  _nodes[index].count = 0;
+  return index;
+}
+
+Bounds3f
+LightBVH::bounds() const
+{
+  return _nodes.empty() ? Bounds3f{} : _nodes[0].bounds;
+}
+
+} // end namespace cg
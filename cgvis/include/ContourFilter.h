@@ -28,11 +28,12 @@
 // Class definition for vis contour filter.
 //
 // Author: Paulo Pagliosa
-// Last revision: 11/03/2022
+// Last revision: 19/10/2026
 
 #ifndef __ContourFilter_h
 #define __ContourFilter_h
 
+#include "core/MonotonicArena.h"
 #include "Filter.h"
 #include "PolyData.h"
 
@@ -117,10 +118,14 @@ ContourFilter<Input>::execute()
   output->initializeLocator(input->bounds(), 10);
 
   auto nc = input->cellCount();
+  auto& arena = MonotonicArena::frame();
 
+  // Each cell is constructed in the frame arena, whose memory is
+  // reused by the next cell, instead of allocated in the heap
   for (decltype(nc) i = 0; i < nc; ++i)
   {
-    auto cell = input->cell(i);
+    ArenaScope scope{arena};
+    auto cell = input->cell(i, arena);
     auto nv = valueCount();
 
     for (decltype(nv) i = 0; i < nv; ++i)
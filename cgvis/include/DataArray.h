@@ -28,17 +28,23 @@
 // Class definition for generic vis data array.
 //
 // Author: Paulo Pagliosa
-// Last revision: 14/03/2022
+// Last revision: 19/10/2026
 
 #ifndef __DataArray_h
 #define __DataArray_h
 
+#include "core/MemoryAccounting.h"
 #include "Object.h"
 #include <vector>
 
 namespace cg::vis
 { // begin namespace cg::vis
 
+// Vector whose memory is accounted under the vis datasets category
+template <typename T>
+using DataVector =
+  std::vector<T, AccountingAllocator<T, MemoryCategory::VisDatasets>>;
+
 
 /////////////////////////////////////////////////////////////////////
 //
@@ -90,7 +96,7 @@ public:
   void set(int i, const T& value);
 
 protected:
-  std::vector<T> _data;
+  DataVector<T> _data;
   Timestamp _computeTime;
 
 }; // DataArray
@@ -28,7 +28,7 @@
 // Class definition for point locator.
 //
 // Author: Paulo Pagliosa
-// Last revision: 14/09/2022
+// Last revision: 19/10/2026
 
 #ifndef __PointLocator_h
 #define __PointLocator_h
@@ -45,11 +45,13 @@ namespace cg
 //
 // PointLocator: point locator class
 // ============
-template <typename Point, typename real = float>
+template <typename Point,
+  typename real = float,
+  typename PS = std::vector<Point>>
 class PointLocator: public SharedObject
 {
 public:
-  using PointSet = std::vector<Point>;
+  using PointSet = PS;
   using Grid = RegionGrid3<real, IndexList<>>;
   using id_type = typename Grid::id_type;
 
@@ -73,7 +75,7 @@ public:
 
   auto index(const Point& p) const
   {
-    return const_cast<PointLocator<Point, real>*>(this)->test(p);
+    return const_cast<PointLocator*>(this)->test(p);
   }
 
   int add(const Point& p)
@@ -90,9 +92,9 @@ private:
 
 }; // PointLocator
 
-template <typename Point, typename real>
+template <typename Point, typename real, typename PS>
 void
-PointLocator<Point, real>::setPointBuffer(PointSet& buffer)
+PointLocator<Point, real, PS>::setPointBuffer(PointSet& buffer)
 {
   if (&buffer != _points)
   {
@@ -101,9 +103,9 @@ PointLocator<Point, real>::setPointBuffer(PointSet& buffer)
   }
 }
 
-template <typename Point, typename real>
+template <typename Point, typename real, typename PS>
 void
-PointLocator<Point, real>::clear()
+PointLocator<Point, real, PS>::clear()
 {
   _points->clear();
   for (auto e = _grid.end(), i = _grid.begin(); i != e;)
@@ -129,9 +131,9 @@ lt(const Point& p, real a)
 
 } // end namespace internal
 
-template <typename Point, typename real>
+template <typename Point, typename real, typename PS>
 int
-PointLocator<Point, real>::test(const Point& p, bool insert)
+PointLocator<Point, real, PS>::test(const Point& p, bool insert)
 {
   using vec3 = Vector3<real>;
   using index_type = Index3<id_type>;
@@ -174,9 +176,9 @@ PointLocator<Point, real>::test(const Point& p, bool insert)
   return -1;
 }
 
-template <typename Point, typename real>
+template <typename Point, typename real, typename PS>
 int
-PointLocator<Point, real>::test(id_type cid, const Point& p, bool insert)
+PointLocator<Point, real, PS>::test(id_type cid, const Point& p, bool insert)
 {
   /*
   if (cid >= _grid.length() || cid < 0)
@@ -28,7 +28,7 @@
 // Class definition for vis poly data.
 //
 // Author: Paulo Pagliosa
-// Last revision: 16/03/2022
+// Last revision: 19/10/2026
 
 #ifndef __PolyData_h
 #define __PolyData_h
@@ -155,12 +155,12 @@ public:
   }
 
 private:
-  using Locator = PointLocator<vec3f>;
+  using Locator = PointLocator<vec3f, float, DataVector<vec3f>>;
 
-  std::vector<PointData> _points;
-  std::vector<LineData> _lines;
-  std::vector<TriangleData> _triangles;
-  std::vector<vec3f> _vertices;
+  DataVector<PointData> _points;
+  DataVector<LineData> _lines;
+  DataVector<TriangleData> _triangles;
+  DataVector<vec3f> _vertices;
   float _pointSize{4};
   Bounds3f _bounds;
   Reference<Locator> _locator;
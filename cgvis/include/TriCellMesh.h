@@ -28,11 +28,12 @@
 // Class definition for vis triangle mesh.
 //
 // Author: Paulo Pagliosa
-// Last revision: 15/03/2022
+// Last revision: 19/10/2026
 
 #ifndef __TriCellMesh_h
 #define __TriCellMesh_h
 
+#include "core/MonotonicArena.h"
 #include "graphics/Primitive.h"
 #include "graphics/TriangleMeshShape.h"
 #include "DataSet.h"
@@ -88,6 +89,9 @@ public:
 
   Reference<cell_type> cell(int i);
 
+  /// Constructs the cell \p i in \p arena (see ArenaPtr).
+  ArenaPtr<cell_type> cell(int i, MonotonicArena& arena);
+
   const TriangleMesh* tesselate() const override;
   virtual vec3f normal(const Intersection&) const override;;
   Bounds3f bounds() const override;
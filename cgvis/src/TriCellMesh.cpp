@@ -28,7 +28,7 @@
 // Soure file for vis triangle mesh.
 //
 // Author: Paulo Pagliosa
-// Last revision: 15/03/2022
+// Last revision: 19/10/2026
 
 #include "TriCellMesh.h"
 
@@ -47,6 +47,13 @@ TriCellMesh::cell(int i)
   return new cell_type{*this, t.v[0], t.v[1], t.v[2]};
 }
 
+ArenaPtr<TriCellMesh::cell_type>
+TriCellMesh::cell(int i, MonotonicArena& arena)
+{
+  const auto& t = mesh()->data().triangles[i];
+  return arena.make<cell_type>(*this, t.v[0], t.v[1], t.v[2]);
+}
+
 const TriangleMesh*
 TriCellMesh::tesselate() const
 {